@@ -707,6 +707,10 @@ bool ConvertADT(char* filename, char* filename2, int cell_y, int cell_x, uint32
             map.heightMapSize += sizeof(V9) + sizeof(V8);
     }
 
+    // keep the next sections 4 byte aligned, the server uses the arrays of the file in place
+    uint32 heightPadding = (4 - map.heightMapSize % 4) % 4;
+    map.heightMapSize += heightPadding;
+
     // Get from MCLQ chunk (old)
     for (int i = 0; i < ADT_CELLS_PER_GRID; i++)
     {
@@ -974,6 +978,11 @@ bool ConvertADT(char* filename, char* filename2, int cell_y, int cell_x, uint32
             fwrite(V8, sizeof(V8), 1, output);
         }
     }
+    if (heightPadding)
+    {
+        uint8 padding[4] = { 0, 0, 0, 0 };
+        fwrite(padding, heightPadding, 1, output);
+    }
 
     // Store liquid data if need
     if (map.liquidMapOffset)
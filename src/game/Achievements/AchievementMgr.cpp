@@ -416,6 +416,7 @@ void AchievementMgr::Reset()
 
     m_completedAchievements.clear();
     m_criteriaProgress.clear();
+    m_completedCriteria.clear();
     DeleteFromDB(m_player->GetObjectGuid());
 
     // re-fill data
@@ -602,6 +603,8 @@ void AchievementMgr::LoadFromDB(QueryResult* achievementResult, QueryResult* cri
                     progress.changed = true;
                 }
             }
+
+            UpdateCompletedCriteriaFilter(criteria, achievement);
         }
         while (criteriaResult->NextRow());
         delete criteriaResult;
@@ -811,11 +814,31 @@ void AchievementMgr::UpdateAchievementCriteria(AchievementCriteriaTypes type, ui
     if (!sWorld.getConfig(CONFIG_BOOL_GM_ALLOW_ACHIEVEMENT_GAINS) && m_player->GetSession()->GetSecurity() > SEC_PLAYER)
         return;
 
-    AchievementCriteriaEntryList const& achievementCriteriaList = sAchievementMgr.GetAchievementCriteriaByType(type);
+    // most events can only advance the criteria of their own creature, spell, item or map, see the switch below
+    uint32 asset = miscvalue1;
+    switch (type)
+    {
+        case ACHIEVEMENT_CRITERIA_TYPE_WIN_BG:
+        case ACHIEVEMENT_CRITERIA_TYPE_COMPLETE_BATTLEGROUND:
+        case ACHIEVEMENT_CRITERIA_TYPE_DEATH_AT_MAP:
+            if (miscvalue1)
+                asset = GetPlayer()->GetMapId();
+            break;
+        default:
+            break;
+    }
+
+    AchievementCriteriaEntryList const& achievementCriteriaList = asset && AchievementGlobalMgr::IsCriteriaTypeIndexedByAsset(type)
+            ? sAchievementMgr.GetAchievementCriteriaByAsset(type, asset)
+            : sAchievementMgr.GetAchievementCriteriaByType(type);
     for (AchievementCriteriaEntryList::const_iterator itr = achievementCriteriaList.begin(); itr != achievementCriteriaList.end(); ++itr)
     {
         AchievementCriteriaEntry const* achievementCriteria = *itr;
 
+        // cheap check before looking at the achievement
+        if (IsInCompletedCriteriaFilter(achievementCriteria->ID))
+            continue;
+
         AchievementEntry const* achievement = sAchievementStore.LookupEntry(achievementCriteria->referredAchievement);
         // Checked in LoadAchievementCriteriaList
 
@@ -1920,6 +1943,24 @@ bool AchievementMgr::IsCompletedCriteria(AchievementCriteriaEntry const* achieve
     return progress->counter >= maxcounter || (achievement->flags & ACHIEVEMENT_FLAG_REQ_COUNT && progress->counter);
 }
 
+void AchievementMgr::UpdateCompletedCriteriaFilter(AchievementCriteriaEntry const* criteria, AchievementEntry const* achievement)
+{
+    // completion of these also depends on the realm state
+    if (achievement->flags & (ACHIEVEMENT_FLAG_COUNTER | ACHIEVEMENT_FLAG_REALM_FIRST_REACH | ACHIEVEMENT_FLAG_REALM_FIRST_KILL))
+        return;
+
+    bool completed = IsCompletedCriteria(criteria, achievement);
+    if (criteria->ID >= m_completedCriteria.size())
+    {
+        if (!completed)
+            return;
+
+        m_completedCriteria.resize(sAchievementCriteriaStore.GetNumRows());
+    }
+
+    m_completedCriteria[criteria->ID] = completed;
+}
+
 void AchievementMgr::CompletedCriteriaFor(AchievementEntry const* achievement)
 {
     // counter can never complete
@@ -2066,6 +2107,8 @@ void AchievementMgr::SetCriteriaProgress(AchievementCriteriaEntry const* criteri
     progress->counter = newValue;
     progress->changed = true;
 
+    UpdateCompletedCriteriaFilter(criteria, achievement);
+
     // update client side value
     SendCriteriaUpdate(criteria->ID, progress);
 
@@ -2377,6 +2420,58 @@ AchievementCriteriaEntryList const& AchievementGlobalMgr::GetAchievementCriteria
     return m_AchievementCriteriasByType[type];
 }
 
+AchievementCriteriaEntryList const& AchievementGlobalMgr::GetAchievementCriteriaByAsset(AchievementCriteriaTypes type, uint32 asset) const
+{
+    static AchievementCriteriaEntryList const emptyList;
+
+    AchievementCriteriaListByAsset::const_iterator itr = m_AchievementCriteriasByAsset[type].find(asset);
+    return itr != m_AchievementCriteriasByAsset[type].end() ? itr->second : emptyList;
+}
+
+/**
+ * types for which AchievementMgr::UpdateAchievementCriteria skips every criteria whose asset (raw.value)
+ * is not the one of the event, as long as the event has one
+ */
+bool AchievementGlobalMgr::IsCriteriaTypeIndexedByAsset(AchievementCriteriaTypes type)
+{
+    switch (type)
+    {
+        case ACHIEVEMENT_CRITERIA_TYPE_KILL_CREATURE:
+        case ACHIEVEMENT_CRITERIA_TYPE_WIN_BG:                  // by player map
+        case ACHIEVEMENT_CRITERIA_TYPE_REACH_SKILL_LEVEL:
+        case ACHIEVEMENT_CRITERIA_TYPE_LEARN_SKILL_LEVEL:
+        case ACHIEVEMENT_CRITERIA_TYPE_COMPLETE_QUESTS_IN_ZONE:
+        case ACHIEVEMENT_CRITERIA_TYPE_CURRENCY_EARNED:
+        case ACHIEVEMENT_CRITERIA_TYPE_COMPLETE_BATTLEGROUND:    // by player map
+        case ACHIEVEMENT_CRITERIA_TYPE_DEATH_AT_MAP:             // by player map
+        case ACHIEVEMENT_CRITERIA_TYPE_KILLED_BY_CREATURE:
+        case ACHIEVEMENT_CRITERIA_TYPE_COMPLETE_QUEST:
+        case ACHIEVEMENT_CRITERIA_TYPE_BE_SPELL_TARGET:
+        case ACHIEVEMENT_CRITERIA_TYPE_BE_SPELL_TARGET2:
+        case ACHIEVEMENT_CRITERIA_TYPE_CAST_SPELL:
+        case ACHIEVEMENT_CRITERIA_TYPE_CAST_SPELL2:
+        case ACHIEVEMENT_CRITERIA_TYPE_LEARN_SPELL:
+        case ACHIEVEMENT_CRITERIA_TYPE_LOOT_TYPE:
+        case ACHIEVEMENT_CRITERIA_TYPE_OWN_ITEM:
+        case ACHIEVEMENT_CRITERIA_TYPE_USE_ITEM:
+        case ACHIEVEMENT_CRITERIA_TYPE_LOOT_ITEM:
+        case ACHIEVEMENT_CRITERIA_TYPE_GAIN_REPUTATION:
+        case ACHIEVEMENT_CRITERIA_TYPE_DO_EMOTE:
+        case ACHIEVEMENT_CRITERIA_TYPE_EQUIP_ITEM:
+        case ACHIEVEMENT_CRITERIA_TYPE_USE_GAMEOBJECT:
+        case ACHIEVEMENT_CRITERIA_TYPE_FISH_IN_GAMEOBJECT:
+        case ACHIEVEMENT_CRITERIA_TYPE_LEARN_SKILLLINE_SPELLS:
+        case ACHIEVEMENT_CRITERIA_TYPE_LEARN_SKILL_LINE:
+        case ACHIEVEMENT_CRITERIA_TYPE_HK_CLASS:
+        case ACHIEVEMENT_CRITERIA_TYPE_HK_RACE:
+        case ACHIEVEMENT_CRITERIA_TYPE_HIGHEST_TEAM_RATING:
+        case ACHIEVEMENT_CRITERIA_TYPE_HIGHEST_PERSONAL_RATING:
+            return true;
+        default:
+            return false;
+    }
+}
+
 AchievementCriteriaEntryList const* AchievementGlobalMgr::GetAchievementCriteriaByAchievement(uint32 id)
 {
     AchievementCriteriaListByAchievement::const_iterator itr = m_AchievementCriteriaListByAchievement.find(id);
@@ -2459,6 +2554,8 @@ void AchievementGlobalMgr::LoadAchievementCriteriaList()
         }
 
         m_AchievementCriteriasByType[criteria->requiredType].push_back(criteria);
+        if (IsCriteriaTypeIndexedByAsset(AchievementCriteriaTypes(criteria->requiredType)))
+            m_AchievementCriteriasByAsset[criteria->requiredType][criteria->raw.value].push_back(criteria);
         m_AchievementCriteriaListByAchievement[criteria->referredAchievement].push_back(criteria);
         ++count;
     }
@@ -175,6 +175,54 @@ void AuctionHouseMgr::SendAuctionWonMail(AuctionEntry* auction)
     }
 }
 
+void AuctionHouseMgr::SaveNewAuctionsToDB(std::vector<AuctionEntry const*> const& auctions)
+{
+    // rows per INSERT request
+    uint32 const batchSize = 100;
+
+    if (auctions.empty())
+        return;
+
+    CharacterDatabase.BeginTransaction();
+
+    for (size_t i = 0; i < auctions.size();)
+    {
+        std::ostringstream itemRows;
+        std::ostringstream auctionRows;
+        itemRows << "INSERT INTO item_instance (guid,owner_guid,data,text) VALUES ";
+        auctionRows << "INSERT INTO auction (id,houseid,itemguid,item_template,item_count,item_randompropertyid,itemowner,buyoutprice,time,moneyTime,buyguid,lastbid,startbid,deposit) VALUES ";
+
+        uint32 itemCount = 0;
+        for (size_t end = std::min(auctions.size(), i + batchSize); i < end; ++i)
+        {
+            AuctionEntry const* auction = auctions[i];
+
+            // new items, so nothing to delete first unlike Item::SaveToDB
+            if (Item* item = GetAItem(auction->itemGuidLow))
+            {
+                std::string text = item->GetText();
+                CharacterDatabase.escape_string(text);
+
+                itemRows << (itemCount++ ? "," : "") << "('" << item->GetGUIDLow() << "','" << item->GetOwnerGuid().GetCounter() << "','"
+                         << item->GetDataString() << "','" << text << "')";
+
+                item->SetState(ITEM_UNCHANGED);
+            }
+
+            auctionRows << (i % batchSize ? "," : "") << "('" << auction->Id << "','" << auction->auctionHouseEntry->houseId << "','" << auction->itemGuidLow << "','"
+                        << auction->itemTemplate << "','" << auction->itemCount << "','" << auction->itemRandomPropertyId << "','" << auction->owner << "','"
+                        << auction->buyout << "','" << uint64(auction->expireTime) << "','" << uint64(auction->moneyDeliveryTime) << "','" << auction->bidder << "','"
+                        << auction->bid << "','" << auction->startbid << "','" << auction->deposit << "')";
+        }
+
+        if (itemCount)
+            CharacterDatabase.Execute(itemRows.str().c_str());
+        CharacterDatabase.Execute(auctionRows.str().c_str());
+    }
+
+    CharacterDatabase.CommitTransaction();
+}
+
 // call this method to send mail to auction owner, when auction is successful, it does not clear ram
 void AuctionHouseMgr::SendAuctionSuccessfulMail(AuctionEntry* auction)
 {
@@ -564,43 +612,106 @@ AuctionHouseEntry const* AuctionHouseMgr::GetAuctionHouseEntry(Unit* unit)
 void AuctionHouseObject::Update()
 {
     time_t curTime = sWorld.GetGameTime();
-    ///- Handle expired auctions
-    for (AuctionEntryMap::iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end();)
+    std::vector<uint32> deletedIds;
+
+    ///- Handle expired auctions, only the ones due are visited
+    while (!m_auctionTimers.empty() && curTime > m_auctionTimers.top().first)
     {
-        if (itr->second->moneyDeliveryTime)                 // pending auction
+        AuctionTimer timer = m_auctionTimers.top();
+        m_auctionTimers.pop();
+
+        AuctionEntryMap::iterator itr = AuctionsMap.find(timer.second);
+        if (itr == AuctionsMap.end())                       // removed meantime
+            continue;
+
+        AuctionEntry* auction = itr->second;
+        if (auction->GetNextEventTime() != timer.first)     // rescheduled meantime
         {
-            if (curTime > itr->second->moneyDeliveryTime)
-            {
-                sAuctionMgr.SendAuctionSuccessfulMail(itr->second);
+            // not expected but never lose an auction that was delayed without ScheduleAuction call
+            if (auction->GetNextEventTime() > timer.first)
+                ScheduleAuction(auction);
+            continue;
+        }
 
-                itr->second->DeleteFromDB();
-                MANGOS_ASSERT(!itr->second->itemGuidLow);   // already removed or send in mail at won
-                delete itr->second;
-                AuctionsMap.erase(itr++);
-                continue;
-            }
+        if (auction->moneyDeliveryTime)                     // pending auction
+        {
+            sAuctionMgr.SendAuctionSuccessfulMail(auction);
+            MANGOS_ASSERT(!auction->itemGuidLow);           // already removed or send in mail at won
         }
         else                                                // active auction
         {
-            if (curTime > itr->second->expireTime)
+            ///- perform the transaction if there was bidder, the auction stays pending until money delivery
+            if (auction->bid)
             {
-                ///- perform the transaction if there was bidder
-                if (itr->second->bid)
-                    itr->second->AuctionBidWinning();
-                ///- cancel the auction if there was no bidder and clear the auction
-                else
-                {
-                    sAuctionMgr.SendAuctionExpiredMail(itr->second);
-
-                    itr->second->DeleteFromDB();
-                    delete itr->second;
-                    AuctionsMap.erase(itr++);
-                    continue;
-                }
+                auction->AuctionBidWinning();
+                continue;
             }
+
+            ///- cancel the auction if there was no bidder and clear the auction
+            sAuctionMgr.SendAuctionExpiredMail(auction);
+        }
+
+        deletedIds.push_back(auction->Id);
+        RemoveFromIndex(auction);
+        delete auction;
+        AuctionsMap.erase(itr);
+    }
+
+    ///- Delete the finished auctions from DB in as few requests as possible
+    for (size_t i = 0; i < deletedIds.size();)
+    {
+        std::ostringstream ss;
+        ss << "DELETE FROM auction WHERE id IN (" << deletedIds[i];
+        for (size_t end = std::min(deletedIds.size(), i + 500); ++i < end;)
+            ss << "," << deletedIds[i];
+        ss << ")";
+
+        CharacterDatabase.Execute(ss.str().c_str());
+    }
+}
+
+void AuctionHouseObject::AddToIndex(AuctionEntry* auction)
+{
+    AuctionEntryList& auctions = m_auctionsByItem[auction->itemTemplate];
+    auctions.push_back(auction);
+
+    if (auctions.size() == 1)
+    {
+        // items without template are still listed by searches not filtering on class
+        ItemPrototype const* proto = ObjectMgr::GetItemPrototype(auction->itemTemplate);
+        uint32 classKey = proto ? (proto->Class << 16) | proto->SubClass : 0xffffffff;
+        m_itemsByClass[classKey].insert(auction->itemTemplate);
+    }
+}
+
+void AuctionHouseObject::RemoveFromIndex(AuctionEntry* auction)
+{
+    AuctionsByItemMap::iterator itr = m_auctionsByItem.find(auction->itemTemplate);
+    if (itr == m_auctionsByItem.end())
+        return;
+
+    AuctionEntryList& auctions = itr->second;
+    AuctionEntryList::iterator found = std::find(auctions.begin(), auctions.end(), auction);
+    if (found == auctions.end())
+        return;
+
+    *found = auctions.back();
+    auctions.pop_back();
+
+    if (auctions.empty())
+    {
+        ItemPrototype const* proto = ObjectMgr::GetItemPrototype(auction->itemTemplate);
+        uint32 classKey = proto ? (proto->Class << 16) | proto->SubClass : 0xffffffff;
+
+        ItemsByClassMap::iterator classItr = m_itemsByClass.find(classKey);
+        if (classItr != m_itemsByClass.end())
+        {
+            classItr->second.erase(auction->itemTemplate);
+            if (classItr->second.empty())
+                m_itemsByClass.erase(classItr);
         }
 
-        ++itr;
+        m_auctionsByItem.erase(itr);
     }
 }
 
@@ -771,15 +882,19 @@ int AuctionEntry::CompareAuctionEntry(uint32 column, const AuctionEntry* auc, Pl
 
 bool AuctionSorter::operator()(const AuctionEntry* auc1, const AuctionEntry* auc2) const
 {
-    if (m_sort[0] == MAX_AUCTION_SORT)                      // not sorted
-        return false;
-
     for (uint32 i = 0; i < MAX_AUCTION_SORT; ++i)
     {
         if (m_sort[i] == MAX_AUCTION_SORT)                  // end of sort
-            return false;
+            break;
+
+        uint32 column = m_sort[i] & ~AUCTION_SORT_REVERSED;
+
+        int res;
+        if (column == 5 && m_itemNames)                     // name = 5
+            res = m_itemNames->find(auc1->itemTemplate)->second.compare(m_itemNames->find(auc2->itemTemplate)->second);
+        else
+            res = auc1->CompareAuctionEntry(column, auc2, m_viewPlayer);
 
-        int res = auc1->CompareAuctionEntry(m_sort[i] & ~AUCTION_SORT_REVERSED, auc2, m_viewPlayer);
         // "equal" by used column
         if (res == 0)
             continue;
@@ -787,76 +902,117 @@ bool AuctionSorter::operator()(const AuctionEntry* auc1, const AuctionEntry* auc
         return (res < 0) == ((m_sort[i] & AUCTION_SORT_REVERSED) == 0);
     }
 
-    return false;                                           // "equal" by all sorts
+    // "equal" by all sorts, keep pages stable between requests
+    return auc1->Id < auc2->Id;
 }
 
-void WorldSession::BuildListAuctionItems(std::vector<AuctionEntry*> const& auctions, WorldPacket& data, std::wstring const& wsearchedname, uint32 listfrom, uint32 levelmin,
+void WorldSession::BuildListAuctionItems(AuctionHouseObject const* auctionHouse, uint8* sort, WorldPacket& data, std::wstring const& wsearchedname, uint32 listfrom, uint32 levelmin,
         uint32 levelmax, uint32 usable, uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality, uint32& count, uint32& totalcount, bool isFull)
 {
-    int loc_idx = _player->GetSession()->GetSessionDbLocaleIndex();
-
-    for (std::vector<AuctionEntry*>::const_iterator itr = auctions.begin(); itr != auctions.end(); ++itr)
+    if (isFull)
     {
-        AuctionEntry* Aentry = *itr;
-        if (Aentry->moneyDeliveryTime)
-            continue;
-        Item* item = sAuctionMgr.GetAItem(Aentry->itemGuidLow);
-        if (!item)
-            continue;
-
-        if (isFull)
+        for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = auctionHouse->GetAuctions().begin(); itr != auctionHouse->GetAuctions().end(); ++itr)
         {
+            AuctionEntry* Aentry = itr->second;
+            if (Aentry->moneyDeliveryTime || !sAuctionMgr.GetAItem(Aentry->itemGuidLow))
+                continue;
+
             ++count;
+            ++totalcount;
             Aentry->BuildAuctionInfo(data);
         }
-        else
-        {
-            ItemPrototype const* proto = item->GetProto();
+        return;
+    }
 
-            if (itemClass != 0xffffffff && proto->Class != itemClass)
-                continue;
+    int loc_idx = GetSessionDbLocaleIndex();
 
-            if (itemSubClass != 0xffffffff && proto->SubClass != itemSubClass)
-                continue;
+    bool sortByName = false;
+    for (uint32 i = 0; i < MAX_AUCTION_SORT && sort[i] != MAX_AUCTION_SORT; ++i)
+        if ((sort[i] & ~AUCTION_SORT_REVERSED) == 5)
+            sortByName = true;
 
-            if (inventoryType != 0xffffffff && proto->InventoryType != inventoryType)
-                continue;
+    std::vector<AuctionEntry*> auctions;
+    AuctionSorter::ItemNameMap itemNames;
 
-            if (quality != 0xffffffff && proto->Quality < quality)
-                continue;
+    // template based filters are checked once per item entry instead of once per auction
+    auctionHouse->DoForItemsOfClass(itemClass, itemSubClass, [&](uint32 itemEntry, AuctionHouseObject::AuctionEntryList const& itemAuctions)
+    {
+        ItemPrototype const* proto = ObjectMgr::GetItemPrototype(itemEntry);
+        if (!proto)
+            return;
 
-            if (levelmin != 0x00 && (proto->RequiredLevel < levelmin || (levelmax != 0x00 && proto->RequiredLevel > levelmax)))
-                continue;
+        if (inventoryType != 0xffffffff && proto->InventoryType != inventoryType)
+            return;
 
-            if (usable != 0x00)
-            {
-                if (_player->CanUseItem(item) != EQUIP_ERR_OK)
-                    continue;
+        if (quality != 0xffffffff && proto->Quality < quality)
+            return;
 
-                if (proto->Class == ITEM_CLASS_RECIPE)
-                {
-                    if (SpellEntry const* spell = sSpellTemplate.LookupEntry<SpellEntry>(proto->Spells[0].SpellId))
-                    {
-                        if (_player->HasSpell(spell->EffectTriggerSpell[EFFECT_INDEX_0]))
-                            continue;
-                    }
-                }
+        if (levelmin != 0x00 && (proto->RequiredLevel < levelmin || (levelmax != 0x00 && proto->RequiredLevel > levelmax)))
+            return;
+
+        if (usable != 0x00 && proto->Class == ITEM_CLASS_RECIPE)
+        {
+            if (SpellEntry const* spell = sSpellTemplate.LookupEntry<SpellEntry>(proto->Spells[0].SpellId))
+            {
+                if (_player->HasSpell(spell->EffectTriggerSpell[EFFECT_INDEX_0]))
+                    return;
             }
+        }
 
+        if (!wsearchedname.empty() || sortByName)
+        {
             std::string name = proto->Name1;
             sObjectMgr.GetItemLocaleStrings(proto->ItemId, loc_idx, &name);
 
-            if (!wsearchedname.empty() && !Utf8FitTo(name, wsearchedname))
-                continue;
+            std::wstring wname;
+            if (!Utf8toWStr(name, wname) && !wsearchedname.empty())
+                return;
 
-            if (count < 50 && totalcount >= listfrom)
+            if (!wsearchedname.empty())
             {
-                ++count;
-                Aentry->BuildAuctionInfo(data);
+                std::wstring wlowername = wname;
+                wstrToLower(wlowername);
+                if (wlowername.find(wsearchedname) == std::wstring::npos)
+                    return;
             }
+
+            if (sortByName)
+                itemNames[itemEntry] = wname;
+        }
+
+        for (AuctionEntry* Aentry : itemAuctions)
+        {
+            if (Aentry->moneyDeliveryTime)
+                continue;
+
+            Item* item = sAuctionMgr.GetAItem(Aentry->itemGuidLow);
+            if (!item)
+                continue;
+
+            if (usable != 0x00 && _player->CanUseItem(item) != EQUIP_ERR_OK)
+                continue;
+
+            auctions.push_back(Aentry);
         }
+    });
 
-        ++totalcount;
+    totalcount = auctions.size();
+    if (listfrom >= auctions.size())
+        return;
+
+    // only the requested page has to be ordered
+    AuctionSorter sorter(sort, _player, sortByName ? &itemNames : nullptr);
+    std::vector<AuctionEntry*>::iterator first = auctions.begin() + listfrom;
+    std::vector<AuctionEntry*>::iterator last = auctions.begin() + std::min<size_t>(listfrom + 50, auctions.size());
+
+    if (listfrom)
+        std::nth_element(auctions.begin(), first, auctions.end(), sorter);
+    std::partial_sort(first, last, auctions.end(), sorter);
+
+    for (std::vector<AuctionEntry*>::const_iterator itr = first; itr != last; ++itr)
+    {
+        ++count;
+        (*itr)->BuildAuctionInfo(data);
     }
 }
 
@@ -888,7 +1044,7 @@ void AuctionHouseObject::BuildListPendingSales(WorldPacket& data, Player* player
     }
 }
 
-AuctionEntry* AuctionHouseObject::AddAuction(AuctionHouseEntry const* auctionHouseEntry, Item* newItem, uint32 etime, uint64 bid, uint64 buyout, uint64 deposit, Player* pl /*= nullptr*/)
+AuctionEntry* AuctionHouseObject::AddAuction(AuctionHouseEntry const* auctionHouseEntry, Item* newItem, uint32 etime, uint64 bid, uint64 buyout, uint64 deposit, Player* pl /*= nullptr*/, bool saveToDB /*= true*/)
 {
     uint32 auction_time = uint32(etime * sWorld.getConfig(CONFIG_FLOAT_RATE_AUCTION_TIME));
 
@@ -916,6 +1072,9 @@ AuctionEntry* AuctionHouseObject::AddAuction(AuctionHouseEntry const* auctionHou
 
     sAuctionMgr.AddAItem(newItem);
 
+    if (!saveToDB)
+        return AH;
+
     CharacterDatabase.BeginTransaction();
 
     newItem->SaveToDB();
@@ -994,6 +1153,7 @@ void AuctionEntry::SaveToDB() const
 void AuctionEntry::AuctionBidWinning(Player* newbidder)
 {
     moneyDeliveryTime = time(nullptr) + HOUR;
+    sAuctionMgr.GetAuctionsMap(auctionHouseEntry)->ScheduleAuction(this);
 
     CharacterDatabase.BeginTransaction();
     CharacterDatabase.PExecute("UPDATE auction SET itemguid = 0, moneyTime = '" UI64FMTD "', buyguid = '%u', lastbid = '" UI64FMTD "' WHERE id = '%u'", (uint64)moneyDeliveryTime, bidder, bid, Id);
@@ -74,6 +74,7 @@ struct AuctionEntry
     uint32 GetHouseFaction() const { return auctionHouseEntry->faction; }
     uint64 GetAuctionCut() const;
     uint64 GetAuctionOutBid() const;
+    time_t GetNextEventTime() const { return moneyDeliveryTime ? moneyDeliveryTime : expireTime; }  // expiration or money delivery for pending auctions
     bool BuildAuctionInfo(WorldPacket& data) const;
     void DeleteFromDB() const;
     void SaveToDB() const;
@@ -99,6 +100,15 @@ class AuctionHouseObject
         typedef std::map<uint32, AuctionEntry*> AuctionEntryMap;
         typedef std::pair<AuctionEntryMap::const_iterator, AuctionEntryMap::const_iterator> AuctionEntryMapBounds;
 
+        // secondary indexes used by browse requests, kept in sync with AuctionsMap
+        typedef std::vector<AuctionEntry*> AuctionEntryList;
+        typedef std::unordered_map<uint32, AuctionEntryList> AuctionsByItemMap;     // item entry -> auctions
+        typedef std::map<uint32, std::set<uint32> > ItemsByClassMap;                // class << 16 | subclass -> item entries having auctions
+
+        // auctions by next event time, entries of removed auctions or outdated times are skipped by Update()
+        typedef std::pair<time_t, uint32> AuctionTimer;                               // time, auction id
+        typedef std::priority_queue<AuctionTimer, std::vector<AuctionTimer>, std::greater<AuctionTimer> > AuctionTimerQueue;
+
         uint32 GetCount() { return AuctionsMap.size(); }
 
         AuctionEntryMap const& GetAuctions() const { return AuctionsMap; }
@@ -108,8 +118,13 @@ class AuctionHouseObject
         {
             MANGOS_ASSERT(ah);
             AuctionsMap[ah->Id] = ah;
+            AddToIndex(ah);
+            ScheduleAuction(ah);
         }
 
+        // must be called after each change of the expiration or money delivery time
+        void ScheduleAuction(AuctionEntry const* auction) { m_auctionTimers.push(AuctionTimer(auction->GetNextEventTime(), auction->Id)); }
+
         AuctionEntry* GetAuction(uint32 id) const
         {
             AuctionEntryMap::const_iterator itr = AuctionsMap.find(id);
@@ -118,30 +133,84 @@ class AuctionHouseObject
 
         bool RemoveAuction(uint32 id)
         {
-            return AuctionsMap.erase(id) > 0;
+            AuctionEntryMap::iterator itr = AuctionsMap.find(id);
+            if (itr == AuctionsMap.end())
+                return false;
+
+            RemoveFromIndex(itr->second);
+            AuctionsMap.erase(itr);
+            return true;
+        }
+
+        AuctionEntryList const* GetAuctionsForItem(uint32 itemEntry) const
+        {
+            AuctionsByItemMap::const_iterator itr = m_auctionsByItem.find(itemEntry);
+            return itr != m_auctionsByItem.end() ? &itr->second : nullptr;
         }
 
+        // call worker(itemEntry, auctions) for each item entry with auctions, 0xffffffff class/subclass matches any
+        template<typename Worker>
+        void DoForItemsOfClass(uint32 itemClass, uint32 itemSubClass, Worker const& worker) const;
+
         void Update();
 
         void BuildListBidderItems(WorldPacket& data, Player* player, uint32& count, uint32& totalcount);
         void BuildListOwnerItems(WorldPacket& data, Player* player, uint32& count, uint32& totalcount);
         void BuildListPendingSales(WorldPacket& data, Player* player, uint32& count);
 
-        AuctionEntry* AddAuction(AuctionHouseEntry const* auctionHouseEntry, Item* newItem, uint32 etime, uint64 bid, uint64 buyout = 0, uint64 deposit = 0, Player* pl = nullptr);
+        // saveToDB = false for auctions saved later with AuctionHouseMgr::SaveNewAuctionsToDB
+        AuctionEntry* AddAuction(AuctionHouseEntry const* auctionHouseEntry, Item* newItem, uint32 etime, uint64 bid, uint64 buyout = 0, uint64 deposit = 0, Player* pl = nullptr, bool saveToDB = true);
     private:
+        void AddToIndex(AuctionEntry* auction);
+        void RemoveFromIndex(AuctionEntry* auction);
+
         AuctionEntryMap AuctionsMap;
+        AuctionsByItemMap m_auctionsByItem;
+        ItemsByClassMap m_itemsByClass;
+        AuctionTimerQueue m_auctionTimers;
 };
 
+template<typename Worker>
+void AuctionHouseObject::DoForItemsOfClass(uint32 itemClass, uint32 itemSubClass, Worker const& worker) const
+{
+    ItemsByClassMap::const_iterator begin, end;
+    if (itemClass == 0xffffffff)
+    {
+        begin = m_itemsByClass.begin();
+        end = m_itemsByClass.end();
+    }
+    else if (itemSubClass == 0xffffffff)
+    {
+        begin = m_itemsByClass.lower_bound(itemClass << 16);
+        end = m_itemsByClass.lower_bound((itemClass + 1) << 16);
+    }
+    else
+    {
+        begin = m_itemsByClass.find((itemClass << 16) | itemSubClass);
+        if (begin == m_itemsByClass.end())
+            return;
+        end = std::next(begin);
+    }
+
+    for (ItemsByClassMap::const_iterator itr = begin; itr != end; ++itr)
+        for (uint32 itemEntry : itr->second)
+            worker(itemEntry, m_auctionsByItem.find(itemEntry)->second);
+}
+
 class AuctionSorter
 {
     public:
-        AuctionSorter(AuctionSorter const& sorter) : m_sort(sorter.m_sort), m_viewPlayer(sorter.m_viewPlayer) {}
-        AuctionSorter(uint8* sort, Player* viewPlayer) : m_sort(sort), m_viewPlayer(viewPlayer) {}
+        // item names already converted for the viewer locale, avoids lookups on each name comparison
+        typedef std::unordered_map<uint32, std::wstring> ItemNameMap;
+
+        AuctionSorter(AuctionSorter const& sorter) : m_sort(sorter.m_sort), m_viewPlayer(sorter.m_viewPlayer), m_itemNames(sorter.m_itemNames) {}
+        AuctionSorter(uint8* sort, Player* viewPlayer, ItemNameMap const* itemNames = nullptr) : m_sort(sort), m_viewPlayer(viewPlayer), m_itemNames(itemNames) {}
         bool operator()(const AuctionEntry* auc1, const AuctionEntry* auc2) const;
 
     private:
         uint8* m_sort;
         Player* m_viewPlayer;
+        ItemNameMap const* m_itemNames;
 };
 
 enum AuctionHouseType
@@ -180,6 +249,9 @@ class AuctionHouseMgr
         void SendAuctionExpiredMail(AuctionEntry* auction);
         static uint64 GetAuctionDeposit(AuctionHouseEntry const* entry, uint32 time, Item* pItem);
 
+        // save new auctions and their items in one transaction with multi-row inserts
+        void SaveNewAuctionsToDB(std::vector<AuctionEntry const*> const& auctions);
+
         static uint32 GetAuctionHouseTeam(AuctionHouseEntry const* house);
         static AuctionHouseEntry const* GetAuctionHouseEntry(Unit* unit);
 
@@ -345,6 +345,7 @@ void AuctionBotConfig::GetConfigFromFile()
 
     setConfig(CONFIG_UINT32_AHBOT_ITEMS_PER_CYCLE_BOOST      , "AuctionHouseBot.ItemsPerCycle.Boost"         , 75);
     setConfig(CONFIG_UINT32_AHBOT_ITEMS_PER_CYCLE_NORMAL     , "AuctionHouseBot.ItemsPerCycle.Normal"        , 20);
+    setConfig(CONFIG_UINT32_AHBOT_SELLER_TIME_BUDGET         , "AuctionHouseBot.Seller.TimeBudget"           , 10);
 
     setConfig(CONFIG_UINT32_AHBOT_ITEM_MIN_ITEM_LEVEL        , "AuctionHouseBot.Items.ItemLevel.Min"         , 0);
     setConfig(CONFIG_UINT32_AHBOT_ITEM_MAX_ITEM_LEVEL        , "AuctionHouseBot.Items.ItemLevel.Max"         , 0);
@@ -1592,12 +1593,26 @@ void AuctionBotSeller::addNewAuctions(AHB_Seller_Config& config)
 
     AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(config.GetHouseType());
 
+    // stop at the time budget, the missing items are added at next updates
+    uint32 timeBudget = sAuctionBotConfig.getConfig(CONFIG_UINT32_AHBOT_SELLER_TIME_BUDGET);
+    uint32 startTime = WorldTimer::getMSTime();
+
+    // saved together after the loop
+    std::vector<AuctionEntry const*> newAuctions;
+    newAuctions.reserve(items);
+
     RandomArray randArray;
     std::vector<std::vector<uint32> > ItemsAdded(MAX_AUCTION_QUALITY, std::vector<uint32> (MAX_ITEM_CLASS));
     // Main loop
     // getRandomArray will give what categories of items should be added (return true if there is at least 1 items missed)
     while (getRandomArray(config, randArray, ItemsAdded) && (items > 0))
     {
+        if (timeBudget && WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime()) >= timeBudget)
+        {
+            DEBUG_FILTER_LOG(LOG_FILTER_AHBOT_SELLER, "AHBot: Time budget reached with %u items left to add this cycle.", items);
+            break;
+        }
+
         --items;
 
         // Select random position from missed items table
@@ -1626,7 +1641,7 @@ void AuctionBotSeller::addNewAuctions(AHB_Seller_Config& config)
         if (!item)
         {
             sLog.outError("AHBot: Item::CreateItem() returned nullptr for item %u (stack: %u)", itemID, stackCount);
-            return;
+            break;
         }
 
         uint64 buyoutPrice;
@@ -1641,8 +1656,10 @@ void AuctionBotSeller::addNewAuctions(AHB_Seller_Config& config)
         // Price of items are set here
         SetPricesOfItem(config, buyoutPrice, bidPrice, ItemQualities(prototype->Quality));
 
-        auctionHouse->AddAuction(ahEntry, item, urand(config.GetMinTime(), config.GetMaxTime()) * HOUR, bidPrice, buyoutPrice);
+        newAuctions.push_back(auctionHouse->AddAuction(ahEntry, item, urand(config.GetMinTime(), config.GetMaxTime()) * HOUR, bidPrice, buyoutPrice, 0, nullptr, false));
     }
+
+    sAuctionMgr.SaveNewAuctionsToDB(newAuctions);
 }
 
 bool AuctionBotSeller::Update(AuctionHouseType houseType)
@@ -1768,13 +1785,19 @@ void AuctionHouseBot::Rebuild(bool all)
 {
     for (uint32 i = 0; i < MAX_AUCTION_HOUSE_TYPE; ++i)
     {
-        AuctionHouseObject::AuctionEntryMapBounds bounds = sAuctionMgr.GetAuctionsMap(AuctionHouseType(i))->GetAuctionsBounds();
+        AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(AuctionHouseType(i));
+        AuctionHouseObject::AuctionEntryMapBounds bounds = auctionHouse->GetAuctionsBounds();
         for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
         {
             AuctionEntry* entry = itr->second;
-            if (!entry->owner)                              // ahbot auction
+            if (!entry->owner && !entry->moneyDeliveryTime) // active ahbot auction
+            {
                 if (all || entry->bid == 0)                 // expire now auction if no bid or forced
+                {
                     entry->expireTime = sWorld.GetGameTime();
+                    auctionHouse->ScheduleAuction(entry);
+                }
+            }
         }
     }
 }
@@ -44,6 +44,7 @@ enum AuctionBotConfigUInt32Values
     CONFIG_UINT32_AHBOT_MINTIME,
     CONFIG_UINT32_AHBOT_ITEMS_PER_CYCLE_BOOST,
     CONFIG_UINT32_AHBOT_ITEMS_PER_CYCLE_NORMAL,
+    CONFIG_UINT32_AHBOT_SELLER_TIME_BUDGET,
     CONFIG_UINT32_AHBOT_ALLIANCE_ITEM_AMOUNT_RATIO,
     CONFIG_UINT32_AHBOT_HORDE_ITEM_AMOUNT_RATIO,
     CONFIG_UINT32_AHBOT_NEUTRAL_ITEM_AMOUNT_RATIO,
@@ -218,10 +218,12 @@ class ChatHandler
         bool HandleCharacterLevelCommand(char* args);
         bool HandleCharacterRenameCommand(char* args);
         bool HandleCharacterReputationCommand(char* args);
+        bool HandleCharacterNetworkCommand(char* args);
         bool HandleCharacterTitlesCommand(char* args);
 
         bool HandleDebugAnimCommand(char* args);
         bool HandleDebugArenaCommand(char* args);
+        bool HandleDebugDbBenchCommand(char* args);
         bool HandleDebugBattlegroundCommand(char* args);
         bool HandleDebugBattlegroundStartCommand(char* args);
         bool HandleDebugGetItemStateCommand(char* args);
@@ -531,8 +533,12 @@ class ChatHandler
         bool HandleSendMassMailCommand(char* args);
         bool HandleSendMassMoneyCommand(char* args);
 
+        bool HandleServerAuthQueueCommand(char* args);
+        bool HandleServerCompressionCommand(char* args);
         bool HandleServerCorpsesCommand(char* args);
+        bool HandleServerDbQueueCommand(char* args);
         bool HandleServerExitCommand(char* args);
+        bool HandleServerGridLoadsCommand(char* args);
         bool HandleServerIdleRestartCommand(char* args);
         bool HandleServerIdleShutDownCommand(char* args);
         bool HandleServerInfoCommand(char* args);
@@ -3781,6 +3781,31 @@ bool ChatHandler::HandleCharacterReputationCommand(char* args)
     return true;
 }
 
+bool ChatHandler::HandleCharacterNetworkCommand(char* args)
+{
+    Player* target;
+    if (!ExtractPlayerTarget(&args, &target))
+        return false;
+
+    MaNGOS::SocketOutputStats stats;
+    if (!target || !target->GetSession()->GetOutputStats(stats))
+    {
+        SendSysMessage(LANG_PLAYER_NOT_FOUND);
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    uint64 const sendCalls = std::max<uint64>(stats.sendCalls, 1);
+    uint64 const flushes = std::max<uint64>(stats.flushes, 1);
+
+    PSendSysMessage("%s: " UI64FMTD " packets, " UI64FMTD " bytes in " UI64FMTD " sends (%.1f bytes, %.1f packets per send)",
+                    GetNameLink(target).c_str(), stats.packets, stats.bytes, stats.sendCalls,
+                    double(stats.bytes) / sendCalls, double(stats.packets) / sendCalls);
+    PSendSysMessage("Buffering delay avg %.3f ms max %.3f ms over " UI64FMTD " flushes",
+                    stats.totalDelay / 1000.0 / flushes, stats.maxDelay / 1000.0, stats.flushes);
+    return true;
+}
+
 // change standstate
 bool ChatHandler::HandleModifyStandStateCommand(char* args)
 {
@@ -5294,5 +5319,15 @@ bool ChatHandler::HandleMmapStatsCommand(char* /*args*/)
     PSendSysMessage(" %u triangles (%u vertices)", triCount, triVertCount);
     PSendSysMessage(" %.2f MB of data (not including pointers)", ((float)dataSize / sizeof(unsigned char)) / 1048576);
 
+    if (MMAP::PathCache* pathCache = manager->GetPathCache(m_session->GetPlayer()->GetMapId()))
+    {
+        MMAP::PathStats const stats = pathCache->GetStats();
+        uint64 const lookups = std::max<uint64>(stats.cacheHits + stats.cacheMisses, 1);
+        PSendSysMessage("Paths on current map:");
+        PSendSysMessage(" cache of %u paths, " UI64FMTD " hits " UI64FMTD " misses (%.1f%% hit rate)",
+                        stats.cacheSize, stats.cacheHits, stats.cacheMisses, stats.cacheHits * 100.0 / lookups);
+        PSendSysMessage(" " UI64FMTD " previous paths reused, " UI64FMTD " of them after walking back to the path", stats.corridorReuses, stats.corridorRepairs);
+    }
+
     return true;
 }
@@ -6472,6 +6472,87 @@ bool ChatHandler::HandleServerPLimitCommand(char* args)
     return true;
 }
 
+bool ChatHandler::HandleServerAuthQueueCommand(char* /*args*/)
+{
+    AuthQueueStats const stats = WorldSocket::GetAuthQueueStats();
+    uint64 const processed = std::max<uint64>(stats.processed, 1);
+
+    PSendSysMessage("Account checks: %u waiting (max %u), " UI64FMTD " done, " UI64FMTD " refused (queue limit %u)",
+                    stats.queued, stats.maxQueued, stats.processed, stats.rejected, sWorld.getConfig(CONFIG_UINT32_AUTH_SESSION_QUEUE_LIMIT));
+    PSendSysMessage("Wait avg %.3f ms max %.3f ms, check avg %.3f ms max %.3f ms",
+                    stats.totalWait / 1000.0 / processed, stats.maxWait / 1000.0,
+                    stats.totalTime / 1000.0 / processed, stats.maxTime / 1000.0);
+    return true;
+}
+
+bool ChatHandler::HandleServerGridLoadsCommand(char* /*args*/)
+{
+    GridLoadStats const stats = TerrainManager::GetGridLoadStats();
+    uint64 const loads = std::max<uint64>(stats.loads, 1);
+    uint64 const objectLoads = std::max<uint64>(stats.objectLoads, 1);
+    uint64 const prefetched = std::max<uint64>(stats.prefetchDone, 1);
+
+    PSendSysMessage("Grid terrain loads: " UI64FMTD " (" UI64FMTD " already loaded), avg %.3f ms max %.3f ms",
+                    stats.loads, stats.terrainCached, stats.terrainTime / 1000.0 / loads, stats.maxTerrainTime / 1000.0);
+    PSendSysMessage("Grid object loads: " UI64FMTD ", avg %.3f ms max %.3f ms",
+                    stats.objectLoads, stats.objectTime / 1000.0 / objectLoads, stats.maxObjectTime / 1000.0);
+    if (TerrainManager::IsPrefetchEnabled())
+        PSendSysMessage("Prefetch: " UI64FMTD " queued, " UI64FMTD " done, avg %.3f ms",
+                        stats.prefetchQueued, stats.prefetchDone, stats.prefetchTime / 1000.0 / prefetched);
+    else
+        PSendSysMessage("Prefetch is disabled.");
+    return true;
+}
+
+bool ChatHandler::HandleServerCompressionCommand(char* /*args*/)
+{
+    uint32 threshold = sWorld.getConfig(CONFIG_UINT32_COMPRESSION_THRESHOLD);
+    if (!threshold)
+        PSendSysMessage("Update packet compression is disabled.");
+    else
+        PSendSysMessage("Update packets of %u bytes and more are compressed at level %u.", threshold, sWorld.getConfig(CONFIG_UINT32_COMPRESSION));
+
+    UpdateCompressionStats const stats = UpdateData::GetCompressionStats();
+    uint64 const attempts = std::max<uint64>(stats.packets + stats.skipped, 1);
+
+    PSendSysMessage("Compressed " UI64FMTD " packets (" UI64FMTD " sent uncompressed), " UI64FMTD " bytes to " UI64FMTD " (ratio %.2f), time avg %.3f ms max %.3f ms total %.2f s",
+                    stats.packets, stats.skipped, stats.inputBytes, stats.outputBytes,
+                    stats.outputBytes ? double(stats.inputBytes) / stats.outputBytes : 0.0,
+                    stats.totalTime / 1000.0 / attempts, stats.maxTime / 1000.0, stats.totalTime / 1000000.0);
+    return true;
+}
+
+bool ChatHandler::HandleServerDbQueueCommand(char* /*args*/)
+{
+    struct
+    {
+        char const* name;
+        Database const& db;
+    } const databases[] =
+    {
+        { "World",     WorldDatabase     },
+        { "Character", CharacterDatabase },
+        { "Login",     LoginDatabase     },
+    };
+
+    // async writes and queries of each database share one queue executed by one or more connections (delay threads)
+    for (auto const& database : databases)
+    {
+        for (uint32 i = 0; i < database.db.GetAsyncConnectionCount(); ++i)
+        {
+            SqlDelayStats const stats = database.db.GetAsyncStats(i);
+            uint64 const executed = std::max<uint64>(stats.executed, 1);
+
+            PSendSysMessage("%s DB connection %u: queued %u (max %u), executed " UI64FMTD " (" UI64FMTD " batches), wait avg %.2f ms max %.2f ms, execution avg %.2f ms max %.2f ms",
+                            database.name, i, stats.queueSize, stats.maxQueueSize, stats.executed, stats.batches,
+                            stats.totalWaitTime / 1000.0 / executed, stats.maxWaitTime / 1000.0,
+                            stats.totalExecTime / 1000.0 / executed, stats.maxExecTime / 1000.0);
+        }
+    }
+
+    return true;
+}
+
 bool ChatHandler::HandleCastCommand(char* args)
 {
     if (!*args)
@@ -31,6 +31,7 @@
 #include "Entities/ObjectGuid.h"
 #include "Spells/SpellMgr.h"
 #include "Cinematics/M2Stores.h"
+#include "Database/DatabaseEnv.h"
 
 bool ChatHandler::HandleDebugSendSpellFailCommand(char* args)
 {
@@ -1206,3 +1207,95 @@ bool ChatHandler::HandleDebugSpellModsCommand(char* args)
 
     return true;
 }
+
+// reads every field with the getter matching its type, like the loaders do, so both result paths pay their full conversion cost
+static uint64 ReadDbBenchResult(QueryResult* result, uint64& rows)
+{
+    uint64 checksum = 0;
+    if (!result)
+        return checksum;
+
+    do
+    {
+        Field* fields = result->Fetch();
+        for (uint32 i = 0; i < result->GetFieldCount(); ++i)
+        {
+            switch (fields[i].GetType())
+            {
+                case Field::DB_TYPE_INTEGER: checksum += fields[i].GetUInt64();                 break;
+                case Field::DB_TYPE_FLOAT:   checksum += uint64(fields[i].GetFloat() * 100.0f); break;
+                default:                     checksum += strlen(fields[i].GetString());        break;
+            }
+        }
+        ++rows;
+    }
+    while (result->NextRow());
+
+    delete result;
+    return checksum;
+}
+
+bool ChatHandler::HandleDebugDbBenchCommand(char* args)
+{
+    uint32 iterations;
+    if (!ExtractOptUInt32(&args, iterations, 3) || !iterations)
+        return false;
+
+    // the character queries are the login queries of the first character in the database
+    uint32 guid = 0;
+    if (QueryResult* result = CharacterDatabase.Query("SELECT MIN(guid) FROM characters"))
+    {
+        guid = (*result)[0].GetUInt32();
+        delete result;
+    }
+
+    struct BenchQuery
+    {
+        Database* db;
+        char const* name;
+        char const* sql;                                    // '?' is replaced by the character guid
+    };
+
+    static BenchQuery const queries[] =
+    {
+        { &WorldDatabase,     "creature",        ObjectMgr::GetLoadCreaturesQuery() },
+        { &CharacterDatabase, "login character", "SELECT * FROM characters WHERE guid = ?" },
+        { &CharacterDatabase, "login auras",     "SELECT caster_guid,item_guid,spell,stackcount,remaincharges,basepoints0,basepoints1,basepoints2,periodictime0,periodictime1,periodictime2,maxduration,remaintime,effIndexMask FROM character_aura WHERE guid = ?" },
+        { &CharacterDatabase, "login spells",    "SELECT spell,active,disabled FROM character_spell WHERE guid = ?" },
+        { &CharacterDatabase, "login inventory", "SELECT data,text,bag,slot,item,item_template FROM character_inventory JOIN item_instance ON character_inventory.item = item_instance.guid WHERE character_inventory.guid = ? ORDER BY bag,slot" },
+    };
+    static SqlStatementID statements[countof(queries)];
+
+    PSendSysMessage("Query results read %u times, text protocol vs. prepared statement (binary protocol):", iterations);
+
+    for (size_t q = 0; q < countof(queries); ++q)
+    {
+        BenchQuery const& query = queries[q];
+        bool const usesGuid = strchr(query.sql, '?') != nullptr;
+
+        std::string textSql = query.sql;
+        if (usesGuid)
+            textSql.replace(textSql.find('?'), 1, std::to_string(guid));
+
+        uint64 textRows = 0, binaryRows = 0;
+        uint64 textChecksum = 0, binaryChecksum = 0;
+
+        uint32 start = WorldTimer::getMSTime();
+        for (uint32 i = 0; i < iterations; ++i)
+            textChecksum = ReadDbBenchResult(query.db->Query(textSql.c_str()), textRows);
+        uint32 const textTime = WorldTimer::getMSTimeDiff(start, WorldTimer::getMSTime());
+
+        start = WorldTimer::getMSTime();
+        for (uint32 i = 0; i < iterations; ++i)
+        {
+            SqlStatement stmt = query.db->CreateStatement(statements[q], query.sql);
+            binaryChecksum = ReadDbBenchResult(usesGuid ? stmt.PQuery(guid) : stmt.Query(), binaryRows);
+        }
+        uint32 const binaryTime = WorldTimer::getMSTimeDiff(start, WorldTimer::getMSTime());
+
+        PSendSysMessage("%-16s %8u rows  text %6u ms  binary %6u ms%s", query.name, uint32(textRows / iterations), textTime, binaryTime,
+                        textChecksum != binaryChecksum || textRows != binaryRows ? "  RESULTS DIFFER" : "");
+    }
+
+    return true;
+}
@@ -620,6 +620,8 @@ void WorldSession::HandlePlayerLoginOpcode(WorldPacket & recv_data )
         return;
     }
 
+    // ordered after the last save of this character still pending on the async connections
+    holder->SetSerialKey(GetCharacterSerialKey(playerGuid));
     CharacterDatabase.DelayQueryHolder(&chrHandler, &CharacterHandler::HandlePlayerLoginCallback, holder);
 }
 
@@ -2011,6 +2011,7 @@ void GameObject::UpdateCollisionState() const
         return;
 
     m_model->enable(IsCollisionEnabled() ? GetPhaseMask() : 0);
+    GetMap()->ClearLineOfSightCache();
 }
 
 void GameObject::UpdateModel()
@@ -438,6 +438,14 @@ void Item::UpdateDuration(Player* owner, uint32 diff)
     SetState(ITEM_CHANGED, owner);                          // save new time in database
 }
 
+std::string Item::GetDataString() const
+{
+    std::ostringstream ss;
+    for (uint16 i = 0; i < m_valuesCount; ++i)
+        ss << GetUInt32Value(i) << " ";
+    return ss.str();
+}
+
 void Item::SaveToDB()
 {
     uint32 guid = GetGUIDLow();
@@ -451,12 +459,8 @@ void Item::SaveToDB()
             SqlStatement stmt = CharacterDatabase.CreateStatement(delItem, "DELETE FROM item_instance WHERE guid = ?");
             stmt.PExecute(guid);
 
-            std::ostringstream ss;
-            for (uint16 i = 0; i < m_valuesCount; ++i)
-                ss << GetUInt32Value(i) << " ";
-
             stmt = CharacterDatabase.CreateStatement(insItem, "INSERT INTO item_instance (guid,owner_guid,data,text) VALUES (?, ?, ?, ?)");
-            stmt.PExecute(guid, GetOwnerGuid().GetCounter(), ss.str().c_str(), m_text.c_str());
+            stmt.PExecute(guid, GetOwnerGuid().GetCounter(), GetDataString().c_str(), m_text.c_str());
         } break;
         case ITEM_CHANGED:
         {
@@ -465,11 +469,7 @@ void Item::SaveToDB()
 
             SqlStatement stmt = CharacterDatabase.CreateStatement(updInstance, "UPDATE item_instance SET data = ?, owner_guid = ?, text = ? WHERE guid = ?");
 
-            std::ostringstream ss;
-            for (uint16 i = 0; i < m_valuesCount; ++i)
-                ss << GetUInt32Value(i) << " ";
-
-            stmt.PExecute(ss.str().c_str(), GetOwnerGuid().GetCounter(), m_text.c_str(), guid);
+            stmt.PExecute(GetDataString().c_str(), GetOwnerGuid().GetCounter(), m_text.c_str(), guid);
 
             if (HasFlag(ITEM_FIELD_FLAGS, ITEM_DYNFLAG_WRAPPED))
             {
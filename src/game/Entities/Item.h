@@ -297,6 +297,8 @@ class Item : public Object
         bool IsBoundAccountWide() const { return (GetProto()->Flags & ITEM_FLAG_IS_BOUND_TO_ACCOUNT) != 0; }
         bool IsBindedNotWith(Player const* player) const;
         bool IsBoundByEnchant() const;
+        // item_instance.data column, the update fields separated by spaces
+        std::string GetDataString() const;
         virtual void SaveToDB();
         virtual bool LoadFromDB(uint32 guidLow, Field* fields, ObjectGuid ownerGuid = ObjectGuid());
         virtual void DeleteFromDB();
@@ -228,6 +228,58 @@ void Object::BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) c
     data->AddUpdateBlock(buf);
 }
 
+void Object::BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target, ValuesUpdateCache& cache) const
+{
+    ValuesUpdateCache::Block& block = cache.blocks[GetUpdateViewerClass(target)];
+
+    if (!block.built)
+    {
+        block.built = true;
+        block.data.reserve(500);
+
+        block.data << uint8(UPDATETYPE_VALUES);
+        block.data << GetPackGUID();
+
+        UpdateMask updateMask;
+        updateMask.SetCount(m_valuesCount);
+
+        _SetUpdateBits(&updateMask, target);
+
+        // values follow the block count and the mask, 4 bytes each in the fields order
+        uint32 offset = block.data.wpos() + 1 + updateMask.GetLength();
+        bool perCasterAuraState = isType(TYPEMASK_UNIT) && ((Unit*)this)->HasAuraState(AURA_STATE_CONFLAGRATE);
+
+        BuildValuesUpdate(UPDATETYPE_VALUES, &block.data, &updateMask, target);
+
+        for (uint16 index = 0; index < m_valuesCount; ++index)
+        {
+            if (!updateMask.GetBit(index))
+                continue;
+
+            if (IsPerViewerUpdateField(index, perCasterAuraState))
+                block.perViewerFields.push_back(std::make_pair(index, offset));
+
+            offset += sizeof(uint32);
+        }
+
+        // built for this viewer already
+        data->AddUpdateBlock(block.data);
+        return;
+    }
+
+    if (block.perViewerFields.empty())
+    {
+        data->AddUpdateBlock(block.data);
+        return;
+    }
+
+    ByteBuffer buf(block.data);
+    for (auto const& field : block.perViewerFields)
+        buf.put<uint32>(field.second, GetUpdateFieldValueFor(field.first, target));
+
+    data->AddUpdateBlock(buf);
+}
+
 void Object::BuildOutOfRangeUpdateBlock(UpdateData* data) const
 {
     data->AddOutOfRangeGUID(GetObjectGuid());
@@ -600,67 +652,16 @@ void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* u
             if (updateMask->GetBit(index))
             {
                 if (index == UNIT_NPC_FLAGS)
-                {
-                    uint32 appendValue = m_uint32Values[index];
-
-                    if (GetTypeId() == TYPEID_UNIT)
-                    {
-                        if (!target->canSeeSpellClickOn((Creature*)this))
-                            appendValue &= ~UNIT_NPC_FLAG_SPELLCLICK;
-
-                        if (appendValue & UNIT_NPC_FLAG_TRAINER)
-                        {
-                            if (!((Creature*)this)->IsTrainerOf(target, false))
-                                appendValue &= ~(UNIT_NPC_FLAG_TRAINER | UNIT_NPC_FLAG_TRAINER_CLASS | UNIT_NPC_FLAG_TRAINER_PROFESSION);
-                        }
-
-                        if (appendValue & UNIT_NPC_FLAG_STABLEMASTER)
-                        {
-                            if (target->getClass() != CLASS_HUNTER)
-                                appendValue &= ~UNIT_NPC_FLAG_STABLEMASTER;
-                        }
-                        
-                        if (appendValue & UNIT_NPC_FLAG_FLIGHTMASTER)
-                        {
-                            QuestRelationsMapBounds bounds = sObjectMgr.GetCreatureQuestRelationsMapBounds(((Creature*)this)->GetEntry());
-                            for (QuestRelationsMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
-                            {
-                                Quest const* pQuest = sObjectMgr.GetQuestTemplate(itr->second);
-                                if (target->CanSeeStartQuest(pQuest))
-                                {
-                                    appendValue &= ~UNIT_NPC_FLAG_FLIGHTMASTER;
-                                    break;
-                                }
-                            }
-
-                            bounds = sObjectMgr.GetCreatureQuestInvolvedRelationsMapBounds(((Creature*)this)->GetEntry());
-                            for (QuestRelationsMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
-                            {
-                                Quest const* pQuest = sObjectMgr.GetQuestTemplate(itr->second);
-                                if (target->CanRewardQuest(pQuest, false))
-                                {
-                                    appendValue &= ~UNIT_NPC_FLAG_FLIGHTMASTER;
-                                    break;
-                                }
-                            }
-                        }
-                    }
-
-                    *data << uint32(appendValue);
-                }
+                    *data << GetUpdateFieldValueFor(index, target);
                 else if (index == UNIT_FIELD_AURASTATE)
                 {
+                    // IsPerCasterAuraState set if related pet caster aura state set already
                     if (IsPerCasterAuraState)
-                    {
-                        // IsPerCasterAuraState set if related pet caster aura state set already
-                        if (((Unit*)this)->HasAuraStateForCaster(AURA_STATE_CONFLAGRATE, target->GetObjectGuid()))
-                            *data << m_uint32Values[index];
-                        else
-                            *data << (m_uint32Values[index] & ~(1 << (AURA_STATE_CONFLAGRATE - 1)));
-                    }
+                        *data << GetUpdateFieldValueFor(index, target);
                     else
                         *data << m_uint32Values[index];
                 }
+
                 // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
                 else if (index >= UNIT_FIELD_BASEATTACKTIME && index <= UNIT_FIELD_RANGEDATTACKTIME)
                 {
@@ -686,83 +687,7 @@ void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* u
                 // Hide lootable animation for unallowed players
                 // Handle tapped flag
                 else if (index == UNIT_DYNAMIC_FLAGS)
-                {
-                    Creature* creature = (Creature*)this;
-                    uint32 dynflagsValue = m_uint32Values[index];
-                    bool setTapFlags = false;
-
-                    if (creature->IsAlive())
-                    {
-                        // Checking SPELL_AURA_EMPATHY and caster
-                        if (dynflagsValue & UNIT_DYNFLAG_SPECIALINFO)
-                        {
-                            bool bIsEmpathy = false;
-                            bool bIsCaster = false;
-                            Unit::AuraList const& mAuraEmpathy = creature->GetAurasByType(SPELL_AURA_EMPATHY);
-                            for (Unit::AuraList::const_iterator itr = mAuraEmpathy.begin(); !bIsCaster && itr != mAuraEmpathy.end(); ++itr)
-                            {
-                                bIsEmpathy = true;              // Empathy by aura set
-                                if ((*itr)->GetCasterGuid() == target->GetObjectGuid())
-                                    bIsCaster = true;           // target is the caster of an empathy aura
-                            }
-                            if (bIsEmpathy && !bIsCaster)       // Empathy by aura, but target is not the caster
-                                dynflagsValue &= ~UNIT_DYNFLAG_SPECIALINFO;
-                        }
-
-                        // creature is alive so, not lootable
-                        dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_LOOTABLE;
-                        if (creature->IsInCombat())
-                        {
-                            // as creature is in combat we have to manage tap flags
-                            setTapFlags = true;
-                        }
-                        else
-                        {
-                            // creature is not in combat so its not tapped
-                            dynflagsValue = dynflagsValue & ~(UNIT_DYNFLAG_TAPPED | UNIT_DYNFLAG_TAPPED_BY_PLAYER);
-                            //sLog.outString(">> %s is not in combat so not tapped by %s", this->GetObjectGuid().GetString().c_str(), target->GetObjectGuid().GetString().c_str());
-                        }
-                    }
-                    else
-                    {
-                        // check loot flag
-                        if (creature->loot && creature->loot->CanLoot(target))
-                        {
-                            // creature is dead and this player can loot it
-                            dynflagsValue = dynflagsValue | UNIT_DYNFLAG_LOOTABLE;
-                            //sLog.outString(">> %s is lootable for %s", this->GetObjectGuid().GetString().c_str(), target->GetObjectGuid().GetString().c_str());
-                        }
-                        else
-                        {
-                            // creature is dead but this player cannot loot it
-                            dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_LOOTABLE;
-                            //sLog.outString(">> %s is not lootable for %s", this->GetObjectGuid().GetString().c_str(), target->GetObjectGuid().GetString().c_str());
-                        }
-
-                        // as creature is died we have to manage tap flags
-                        setTapFlags = true;
-                    }
-
-                    // check tap flags
-                    if (setTapFlags)
-                    {
-                        dynflagsValue = dynflagsValue | UNIT_DYNFLAG_TAPPED;
-                        if (creature->IsTappedBy(target))
-                        {
-                            // creature is in combat or died and tapped by this player
-                            dynflagsValue = dynflagsValue | UNIT_DYNFLAG_TAPPED_BY_PLAYER;
-                            //sLog.outString(">> %s is tapped by %s", this->GetObjectGuid().GetString().c_str(), target->GetObjectGuid().GetString().c_str());
-                        }
-                        else
-                        {
-                            // creature is in combat or died but not tapped by this player
-                            dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_TAPPED_BY_PLAYER;
-                            //sLog.outString(">> %s is not tapped by %s", this->GetObjectGuid().GetString().c_str(), target->GetObjectGuid().GetString().c_str());
-                        }
-                    }
-
-                    *data << dynflagsValue;
-                }
+                    *data << GetUpdateFieldValueFor(index, target);
                 else                                        // Unhandled index, just send
                 {
                     // send in current format (float as float, uint32 as uint32)
@@ -845,6 +770,189 @@ void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* u
     }
 }
 
+uint32 Object::GetUpdateViewerClass(Player* target) const
+{
+    uint32 viewerClass = 0;
+
+    if (target == this)
+        viewerClass |= ValuesUpdateCache::VIEWER_SELF;
+
+    if (isType(TYPEMASK_UNIT))
+    {
+        if (target->IsGameMaster())
+            viewerClass |= ValuesUpdateCache::VIEWER_GAMEMASTER;
+    }
+    else if (isType(TYPEMASK_GAMEOBJECT) && !((GameObject*)this)->IsDynTransport())
+    {
+        if (((GameObject*)this)->ActivateToQuest(target) || target->IsGameMaster())
+            viewerClass |= ValuesUpdateCache::VIEWER_QUEST;
+    }
+
+    return viewerClass;
+}
+
+bool Object::IsPerViewerUpdateField(uint16 index, bool perCasterAuraState) const
+{
+    if (!isType(TYPEMASK_UNIT))
+        return false;
+
+    switch (index)
+    {
+        case UNIT_NPC_FLAGS:
+            return GetTypeId() == TYPEID_UNIT;
+        case UNIT_FIELD_AURASTATE:
+            return perCasterAuraState;
+        case UNIT_DYNAMIC_FLAGS:
+            return true;
+        default:
+            return false;
+    }
+}
+
+uint32 Object::GetUpdateFieldValueFor(uint16 index, Player* target) const
+{
+    switch (index)
+    {
+        case UNIT_NPC_FLAGS:
+        {
+            uint32 appendValue = m_uint32Values[index];
+
+            if (GetTypeId() == TYPEID_UNIT)
+            {
+                if (!target->canSeeSpellClickOn((Creature*)this))
+                    appendValue &= ~UNIT_NPC_FLAG_SPELLCLICK;
+
+                if (appendValue & UNIT_NPC_FLAG_TRAINER)
+                {
+                    if (!((Creature*)this)->IsTrainerOf(target, false))
+                        appendValue &= ~(UNIT_NPC_FLAG_TRAINER | UNIT_NPC_FLAG_TRAINER_CLASS | UNIT_NPC_FLAG_TRAINER_PROFESSION);
+                }
+
+                if (appendValue & UNIT_NPC_FLAG_STABLEMASTER)
+                {
+                    if (target->getClass() != CLASS_HUNTER)
+                        appendValue &= ~UNIT_NPC_FLAG_STABLEMASTER;
+                }
+                
+                if (appendValue & UNIT_NPC_FLAG_FLIGHTMASTER)
+                {
+                    QuestRelationsMapBounds bounds = sObjectMgr.GetCreatureQuestRelationsMapBounds(((Creature*)this)->GetEntry());
+                    for (QuestRelationsMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
+                    {
+                        Quest const* pQuest = sObjectMgr.GetQuestTemplate(itr->second);
+                        if (target->CanSeeStartQuest(pQuest))
+                        {
+                            appendValue &= ~UNIT_NPC_FLAG_FLIGHTMASTER;
+                            break;
+                        }
+                    }
+
+                    bounds = sObjectMgr.GetCreatureQuestInvolvedRelationsMapBounds(((Creature*)this)->GetEntry());
+                    for (QuestRelationsMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
+                    {
+                        Quest const* pQuest = sObjectMgr.GetQuestTemplate(itr->second);
+                        if (target->CanRewardQuest(pQuest, false))
+                        {
+                            appendValue &= ~UNIT_NPC_FLAG_FLIGHTMASTER;
+                            break;
+                        }
+                    }
+                }
+            }
+
+            return appendValue;
+        }
+        case UNIT_FIELD_AURASTATE:
+        {
+            // only per viewer while a caster related aura state is set
+            if (((Unit*)this)->HasAuraStateForCaster(AURA_STATE_CONFLAGRATE, target->GetObjectGuid()))
+                return m_uint32Values[index];
+
+            return m_uint32Values[index] & ~(1 << (AURA_STATE_CONFLAGRATE - 1));
+        }
+        case UNIT_DYNAMIC_FLAGS:
+        {
+            Creature* creature = (Creature*)this;
+            uint32 dynflagsValue = m_uint32Values[index];
+            bool setTapFlags = false;
+
+            if (creature->IsAlive())
+            {
+                // Checking SPELL_AURA_EMPATHY and caster
+                if (dynflagsValue & UNIT_DYNFLAG_SPECIALINFO)
+                {
+                    bool bIsEmpathy = false;
+                    bool bIsCaster = false;
+                    Unit::AuraList const& mAuraEmpathy = creature->GetAurasByType(SPELL_AURA_EMPATHY);
+                    for (Unit::AuraList::const_iterator itr = mAuraEmpathy.begin(); !bIsCaster && itr != mAuraEmpathy.end(); ++itr)
+                    {
+                        bIsEmpathy = true;              // Empathy by aura set
+                        if ((*itr)->GetCasterGuid() == target->GetObjectGuid())
+                            bIsCaster = true;           // target is the caster of an empathy aura
+                    }
+                    if (bIsEmpathy && !bIsCaster)       // Empathy by aura, but target is not the caster
+                        dynflagsValue &= ~UNIT_DYNFLAG_SPECIALINFO;
+                }
+
+                // creature is alive so, not lootable
+                dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_LOOTABLE;
+                if (creature->IsInCombat())
+                {
+                    // as creature is in combat we have to manage tap flags
+                    setTapFlags = true;
+                }
+                else
+                {
+                    // creature is not in combat so its not tapped
+                    dynflagsValue = dynflagsValue & ~(UNIT_DYNFLAG_TAPPED | UNIT_DYNFLAG_TAPPED_BY_PLAYER);
+                    //sLog.outString(">> %s is not in combat so not tapped by %s", this->GetObjectGuid().GetString().c_str(), target->GetObjectGuid().GetString().c_str());
+                }
+            }
+            else
+            {
+                // check loot flag
+                if (creature->loot && creature->loot->CanLoot(target))
+                {
+                    // creature is dead and this player can loot it
+                    dynflagsValue = dynflagsValue | UNIT_DYNFLAG_LOOTABLE;
+                    //sLog.outString(">> %s is lootable for %s", this->GetObjectGuid().GetString().c_str(), target->GetObjectGuid().GetString().c_str());
+                }
+                else
+                {
+                    // creature is dead but this player cannot loot it
+                    dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_LOOTABLE;
+                    //sLog.outString(">> %s is not lootable for %s", this->GetObjectGuid().GetString().c_str(), target->GetObjectGuid().GetString().c_str());
+                }
+
+                // as creature is died we have to manage tap flags
+                setTapFlags = true;
+            }
+
+            // check tap flags
+            if (setTapFlags)
+            {
+                dynflagsValue = dynflagsValue | UNIT_DYNFLAG_TAPPED;
+                if (creature->IsTappedBy(target))
+                {
+                    // creature is in combat or died and tapped by this player
+                    dynflagsValue = dynflagsValue | UNIT_DYNFLAG_TAPPED_BY_PLAYER;
+                    //sLog.outString(">> %s is tapped by %s", this->GetObjectGuid().GetString().c_str(), target->GetObjectGuid().GetString().c_str());
+                }
+                else
+                {
+                    // creature is in combat or died but not tapped by this player
+                    dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_TAPPED_BY_PLAYER;
+                    //sLog.outString(">> %s is not tapped by %s", this->GetObjectGuid().GetString().c_str(), target->GetObjectGuid().GetString().c_str());
+                }
+            }
+
+            return dynflagsValue;
+        }
+        default:
+            return m_uint32Values[index];
+    }
+}
+
 void Object::ClearUpdateMask(bool remove)
 {
     if (m_uint32Values)
@@ -1148,7 +1256,7 @@ bool Object::PrintEntryError(char const* descr) const
     return false;
 }
 
-void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players)
+void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players, ValuesUpdateCache* cache)
 {
     UpdateDataMapType::iterator iter = update_players.find(pl);
 
@@ -1159,7 +1267,10 @@ void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_play
         iter = p.first;
     }
 
-    BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
+    if (cache)
+        BuildValuesUpdateBlockForPlayer(&iter->second, iter->first, *cache);
+    else
+        BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
 }
 
 void Object::AddToClientUpdateList()
@@ -2229,12 +2340,13 @@ struct WorldObjectChangeAccumulator
 {
     UpdateDataMapType& i_updateDatas;
     WorldObject& i_object;
+    ValuesUpdateCache i_cache;                              // most viewers get the same values block
     WorldObjectChangeAccumulator(WorldObject& obj, UpdateDataMapType& d) : i_updateDatas(d), i_object(obj)
     {
         // send self fields changes in another way, otherwise
         // with new camera system when player's camera too far from player, camera wouldn't receive packets and changes from player
         if (i_object.isType(TYPEMASK_PLAYER))
-            i_object.BuildUpdateDataForPlayer((Player*)&i_object, i_updateDatas);
+            i_object.BuildUpdateDataForPlayer((Player*)&i_object, i_updateDatas, &i_cache);
     }
 
     void Visit(CameraMapType& m)
@@ -2243,7 +2355,7 @@ struct WorldObjectChangeAccumulator
         {
             Player* owner = iter->getSource()->GetOwner();
             if (owner != &i_object && owner->HasAtClient(&i_object))
-                i_object.BuildUpdateDataForPlayer(owner, i_updateDatas);
+                i_object.BuildUpdateDataForPlayer(owner, i_updateDatas, &i_cache);
         }
     }
 
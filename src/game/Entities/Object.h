@@ -101,6 +101,30 @@ class Eluna;
 
 typedef std::unordered_map<Player*, UpdateData> UpdateDataMapType;
 
+// Values update blocks of one object built by one BuildUpdateData, shared by the viewers of a same class.
+// Fields whose value depends on the viewer itself are rewritten in a copy of the block for each of them.
+struct ValuesUpdateCache
+{
+    enum ViewerClass
+    {
+        VIEWER_SELF         = 0x01,                         // player object itself, sees its private fields
+        VIEWER_GAMEMASTER   = 0x02,
+        VIEWER_QUEST        = 0x04,                         // gameobject activated for the viewer quests
+        MAX_VIEWER_CLASSES  = 0x08
+    };
+
+    struct Block
+    {
+        Block() : built(false), data(0) {}
+
+        bool built;
+        ByteBuffer data;
+        std::vector<std::pair<uint16, uint32> > perViewerFields;    // field index, offset in data
+    };
+
+    Block blocks[MAX_VIEWER_CLASSES];
+};
+
 // cooldown system
 typedef std::chrono::system_clock Clock;
 typedef std::chrono::time_point<std::chrono::system_clock, std::chrono::milliseconds> TimePoint;
@@ -349,6 +373,7 @@ class Object
         void SendForcedObjectUpdate();
 
         void BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) const;
+        void BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target, ValuesUpdateCache& cache) const;
         void BuildOutOfRangeUpdateBlock(UpdateData* data) const;
 
         virtual void DestroyForPlayer(Player* target, bool anim = false) const;
@@ -568,7 +593,11 @@ class Object
 
         void BuildMovementUpdate(ByteBuffer* data, uint16 updateFlags) const;
         void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* updateMask, Player* target) const;
-        void BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players);
+        void BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players, ValuesUpdateCache* cache = nullptr);
+
+        uint32 GetUpdateViewerClass(Player* target) const;
+        bool IsPerViewerUpdateField(uint16 index, bool perCasterAuraState) const;
+        uint32 GetUpdateFieldValueFor(uint16 index, Player* target) const;
 
         uint16 m_objectType;
 
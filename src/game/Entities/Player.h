@@ -2645,7 +2645,7 @@ class Player : public Unit
         float m_armorPenetrationPct;
         int32 m_spellPenetrationItemMod;
 
-        AuraList m_spellMods[MAX_SPELLMOD];
+        std::list<Aura*> m_spellMods[MAX_SPELLMOD];
         EnchantDurationList m_enchantDuration;
         ItemDurationList m_itemDuration;
 
@@ -567,6 +567,8 @@ Unit::Unit() :
     m_transform = 0;
     m_canModifyStats = false;
 
+    memset(m_modAurasSlot, 0, sizeof(m_modAurasSlot));
+
     for (int i = 0; i < MAX_SPELL_IMMUNITY; ++i)
         m_spellImmune[i].clear();
     for (int i = 0; i < UNIT_MOD_END; ++i)
@@ -673,6 +675,10 @@ void Unit::Update(uint32 update_diff, uint32 p_time)
 
     CleanupDeletedAuras();
 
+    // no aura list can be iterated here, drop the holes left by the removed auras
+    for (auto& auraList : m_modAuras)
+        auraList->Compact();
+
     if (CanHaveThreatList())
         getThreatManager().UpdateForClient(update_diff);
     else if (IsInCombat())
@@ -863,16 +869,18 @@ bool Unit::CanReachWithMeleeAttack(Unit const* pVictim, float flat_mod /*= 0.0f*
 
 void Unit::RemoveSpellsCausingAura(AuraType auraType)
 {
-    for (AuraList::const_iterator iter = m_modAuras[auraType].begin(); iter != m_modAuras[auraType].end();)
+    AuraList const& auraList = GetAurasByType(auraType);
+    for (AuraList::const_iterator iter = auraList.begin(); iter != auraList.end();)
     {
         RemoveAurasDueToSpell((*iter)->GetId());
-        iter = m_modAuras[auraType].begin();
+        iter = auraList.begin();
     }
 }
 
 void Unit::RemoveSpellsCausingAura(AuraType auraType, SpellAuraHolder* except)
 {
-    for (AuraList::const_iterator iter = m_modAuras[auraType].begin(); iter != m_modAuras[auraType].end();)
+    AuraList const& auraList = GetAurasByType(auraType);
+    for (AuraList::const_iterator iter = auraList.begin(); iter != auraList.end();)
     {
         // skip `except` aura
         if ((*iter)->GetHolder() == except)
@@ -882,18 +890,19 @@ void Unit::RemoveSpellsCausingAura(AuraType auraType, SpellAuraHolder* except)
         }
 
         RemoveAurasDueToSpell((*iter)->GetId(), except);
-        iter = m_modAuras[auraType].begin();
+        iter = auraList.begin();
     }
 }
 
 void Unit::RemoveSpellsCausingAura(AuraType auraType, ObjectGuid casterGuid)
 {
-    for (AuraList::const_iterator iter = m_modAuras[auraType].begin(); iter != m_modAuras[auraType].end();)
+    AuraList const& auraList = GetAurasByType(auraType);
+    for (AuraList::const_iterator iter = auraList.begin(); iter != auraList.end();)
     {
         if ((*iter)->GetCasterGuid() == casterGuid)
         {
             RemoveSpellAuraHolder((*iter)->GetHolder());
-            iter = m_modAuras[auraType].begin();
+            iter = auraList.begin();
         }
         else
             ++iter;
@@ -4826,48 +4835,22 @@ void Unit::DeMorph()
 
 int32 Unit::GetTotalAuraModifier(AuraType auratype) const
 {
-    int32 modifier = 0;
-
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (AuraList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
-        modifier += (*i)->GetModifier()->m_amount;
-
-    return modifier;
+    return GetAurasByType(auratype).GetTotals().modifier;
 }
 
 float Unit::GetTotalAuraMultiplier(AuraType auratype) const
 {
-    float multiplier = 1.0f;
-
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (AuraList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
-        multiplier *= (100.0f + (*i)->GetModifier()->m_amount) / 100.0f;
-
-    return multiplier;
+    return GetAurasByType(auratype).GetTotals().multiplier;
 }
 
 int32 Unit::GetMaxPositiveAuraModifier(AuraType auratype) const
 {
-    int32 modifier = 0;
-
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (AuraList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
-        if ((*i)->GetModifier()->m_amount > modifier)
-            modifier = (*i)->GetModifier()->m_amount;
-
-    return modifier;
+    return GetAurasByType(auratype).GetTotals().maxPositive;
 }
 
 int32 Unit::GetMaxNegativeAuraModifier(AuraType auratype) const
 {
-    int32 modifier = 0;
-
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (AuraList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
-        if ((*i)->GetModifier()->m_amount < modifier)
-            modifier = (*i)->GetModifier()->m_amount;
-
-    return modifier;
+    return GetAurasByType(auratype).GetTotals().maxNegative;
 }
 
 int32 Unit::GetTotalAuraModifierByMiscMask(AuraType auratype, uint32 misc_mask) const
@@ -4877,12 +4860,11 @@ int32 Unit::GetTotalAuraModifierByMiscMask(AuraType auratype, uint32 misc_mask)
 
     int32 modifier = 0;
 
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (AuraList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
+    AuraList::MiscTotalsList const& mTotalMiscList = GetAurasByType(auratype).GetMiscTotals();
+    for (AuraList::MiscTotalsList::const_iterator i = mTotalMiscList.begin(); i != mTotalMiscList.end(); ++i)
     {
-        Modifier* mod = (*i)->GetModifier();
-        if (mod->m_miscvalue & misc_mask)
-            modifier += mod->m_amount;
+        if (i->miscValue & misc_mask)
+            modifier += i->modifier;
     }
     return modifier;
 }
@@ -4894,12 +4876,11 @@ float Unit::GetTotalAuraMultiplierByMiscMask(AuraType auratype, uint32 misc_mask
 
     float multiplier = 1.0f;
 
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (AuraList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
+    AuraList::MiscTotalsList const& mTotalMiscList = GetAurasByType(auratype).GetMiscTotals();
+    for (AuraList::MiscTotalsList::const_iterator i = mTotalMiscList.begin(); i != mTotalMiscList.end(); ++i)
     {
-        Modifier* mod = (*i)->GetModifier();
-        if (mod->m_miscvalue & misc_mask)
-            multiplier *= (100.0f + mod->m_amount) / 100.0f;
+        if (i->miscValue & misc_mask)
+            multiplier *= i->multiplier;
     }
     return multiplier;
 }
@@ -4911,12 +4892,11 @@ int32 Unit::GetMaxPositiveAuraModifierByMiscMask(AuraType auratype, uint32 misc_
 
     int32 modifier = 0;
 
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (AuraList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
+    AuraList::MiscTotalsList const& mTotalMiscList = GetAurasByType(auratype).GetMiscTotals();
+    for (AuraList::MiscTotalsList::const_iterator i = mTotalMiscList.begin(); i != mTotalMiscList.end(); ++i)
     {
-        Modifier* mod = (*i)->GetModifier();
-        if (mod->m_miscvalue & misc_mask && mod->m_amount > modifier)
-            modifier = mod->m_amount;
+        if (i->miscValue & misc_mask && i->maxPositive > modifier)
+            modifier = i->maxPositive;
     }
 
     return modifier;
@@ -4929,12 +4909,11 @@ int32 Unit::GetMaxNegativeAuraModifierByMiscMask(AuraType auratype, uint32 misc_
 
     int32 modifier = 0;
 
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (AuraList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
+    AuraList::MiscTotalsList const& mTotalMiscList = GetAurasByType(auratype).GetMiscTotals();
+    for (AuraList::MiscTotalsList::const_iterator i = mTotalMiscList.begin(); i != mTotalMiscList.end(); ++i)
     {
-        Modifier* mod = (*i)->GetModifier();
-        if (mod->m_miscvalue & misc_mask && mod->m_amount < modifier)
-            modifier = mod->m_amount;
+        if (i->miscValue & misc_mask && i->maxNegative < modifier)
+            modifier = i->maxNegative;
     }
 
     return modifier;
@@ -4942,60 +4921,26 @@ int32 Unit::GetMaxNegativeAuraModifierByMiscMask(AuraType auratype, uint32 misc_
 
 int32 Unit::GetTotalAuraModifierByMiscValue(AuraType auratype, int32 misc_value) const
 {
-    int32 modifier = 0;
-
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (AuraList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
-    {
-        Modifier* mod = (*i)->GetModifier();
-        if (mod->m_miscvalue == misc_value)
-            modifier += mod->m_amount;
-    }
-    return modifier;
+    AuraList::Totals const* totals = GetAurasByType(auratype).GetMiscTotals(misc_value);
+    return totals ? totals->modifier : 0;
 }
 
 float Unit::GetTotalAuraMultiplierByMiscValue(AuraType auratype, int32 misc_value) const
 {
-    float multiplier = 1.0f;
-
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (AuraList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
-    {
-        Modifier* mod = (*i)->GetModifier();
-        if (mod->m_miscvalue == misc_value)
-            multiplier *= (100.0f + mod->m_amount) / 100.0f;
-    }
-    return multiplier;
+    AuraList::Totals const* totals = GetAurasByType(auratype).GetMiscTotals(misc_value);
+    return totals ? totals->multiplier : 1.0f;
 }
 
 int32 Unit::GetMaxPositiveAuraModifierByMiscValue(AuraType auratype, int32 misc_value) const
 {
-    int32 modifier = 0;
-
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (AuraList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
-    {
-        Modifier* mod = (*i)->GetModifier();
-        if (mod->m_miscvalue == misc_value && mod->m_amount > modifier)
-            modifier = mod->m_amount;
-    }
-
-    return modifier;
+    AuraList::Totals const* totals = GetAurasByType(auratype).GetMiscTotals(misc_value);
+    return totals ? totals->maxPositive : 0;
 }
 
 int32 Unit::GetMaxNegativeAuraModifierByMiscValue(AuraType auratype, int32 misc_value) const
 {
-    int32 modifier = 0;
-
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (AuraList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
-    {
-        Modifier* mod = (*i)->GetModifier();
-        if (mod->m_miscvalue == misc_value && mod->m_amount < modifier)
-            modifier = mod->m_amount;
-    }
-
-    return modifier;
+    AuraList::Totals const* totals = GetAurasByType(auratype).GetMiscTotals(misc_value);
+    return totals ? totals->maxNegative : 0;
 }
 
 float Unit::GetTotalAuraMultiplierByMiscValueForMask(AuraType auratype, uint32 mask) const
@@ -5005,12 +4950,11 @@ float Unit::GetTotalAuraMultiplierByMiscValueForMask(AuraType auratype, uint32 m
 
     float multiplier = 1.0f;
 
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (AuraList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
+    AuraList::MiscTotalsList const& mTotalMiscList = GetAurasByType(auratype).GetMiscTotals();
+    for (AuraList::MiscTotalsList::const_iterator i = mTotalMiscList.begin(); i != mTotalMiscList.end(); ++i)
     {
-        Modifier* mod = (*i)->GetModifier();
-        if (mask & (1 << (mod->m_miscvalue - 1)))
-            multiplier *= (100.0f + mod->m_amount) / 100.0f;
+        if (mask & (1 << (i->miscValue - 1)))
+            multiplier *= i->multiplier;
     }
     return multiplier;
 }
@@ -5246,10 +5190,93 @@ bool Unit::AddSpellAuraHolder(SpellAuraHolder* holder)
     return true;
 }
 
+void AuraTypeList::push_back(Aura* aura)
+{
+    m_auras.push_back(aura);
+    ++m_count;
+
+    aura->GetModifier()->m_amount.SetList(this);
+    m_totalsValid = false;
+}
+
+void AuraTypeList::remove(Aura* aura)
+{
+    for (auto& itr : m_auras)
+    {
+        if (itr == aura)
+        {
+            itr = nullptr;
+            --m_count;
+
+            aura->GetModifier()->m_amount.SetList(nullptr);
+            m_totalsValid = false;
+        }
+    }
+}
+
+void AuraTypeList::ComputeTotals() const
+{
+    m_totals = Totals();
+    m_miscTotals.clear();
+
+    for (const_iterator itr = begin(); itr != end(); ++itr)
+    {
+        Modifier const* mod = (*itr)->GetModifier();
+
+        MiscTotals* misc = nullptr;
+        for (auto& miscItr : m_miscTotals)
+        {
+            if (miscItr.miscValue == mod->m_miscvalue)
+            {
+                misc = &miscItr;
+                break;
+            }
+        }
+
+        if (!misc)
+        {
+            m_miscTotals.push_back(MiscTotals(mod->m_miscvalue));
+            misc = &m_miscTotals.back();
+        }
+
+        for (Totals* totals : { &m_totals, static_cast<Totals*>(misc) })
+        {
+            totals->modifier += mod->m_amount;
+            totals->multiplier *= (100.0f + mod->m_amount) / 100.0f;
+            if (mod->m_amount > totals->maxPositive)
+                totals->maxPositive = mod->m_amount;
+            if (mod->m_amount < totals->maxNegative)
+                totals->maxNegative = mod->m_amount;
+        }
+    }
+
+    m_totalsValid = true;
+}
+
+void ModifierAmount::NotifyList()
+{
+    m_list->InvalidateTotals();
+}
+
+Unit::AuraList const Unit::s_emptyAuraList;
+
+Unit::AuraList& Unit::GetModAuraList(AuraType type)
+{
+    uint8& slot = m_modAurasSlot[type];
+    if (!slot)
+    {
+        MANGOS_ASSERT(m_modAuras.size() < 0xFF);
+        m_modAuras.push_back(std::unique_ptr<AuraList>(new AuraList()));
+        slot = uint8(m_modAuras.size());
+    }
+
+    return *m_modAuras[slot - 1];
+}
+
 void Unit::AddAuraToModList(Aura* aura)
 {
     if (aura->GetModifier()->m_auraname < TOTAL_AURAS)
-        m_modAuras[aura->GetModifier()->m_auraname].push_back(aura);
+        GetModAuraList(aura->GetModifier()->m_auraname).push_back(aura);
 }
 
 void Unit::RemoveRankAurasDueToSpell(uint32 spellId)
@@ -5923,7 +5950,7 @@ void Unit::RemoveAura(Aura* Aur, AuraRemoveMode mode)
     // remove from list before mods removing (prevent cyclic calls, mods added before including to aura list - use reverse order)
     if (Aur->GetModifier()->m_auraname < TOTAL_AURAS)
     {
-        m_modAuras[Aur->GetModifier()->m_auraname].remove(Aur);
+        GetModAuraList(Aur->GetModifier()->m_auraname).remove(Aur);
     }
 
     // Set remove mode
@@ -9490,18 +9517,17 @@ void Unit::UpdateVisibilityAndView()
     static const AuraType auratypes[] = {SPELL_AURA_BIND_SIGHT, SPELL_AURA_FAR_SIGHT, SPELL_AURA_NONE};
     for (AuraType const* type = &auratypes[0]; *type != SPELL_AURA_NONE; ++type)
     {
-        AuraList& alist = m_modAuras[*type];
+        AuraList const& alist = GetAurasByType(*type);
         if (alist.empty())
             continue;
 
-        for (AuraList::iterator it = alist.begin(); it != alist.end();)
+        for (AuraList::const_iterator it = alist.begin(); it != alist.end();)
         {
             Aura* aura = (*it);
             Unit* owner = aura->GetCaster();
 
             if (!owner || !isVisibleForOrDetect(owner, this, false))
             {
-                alist.erase(it);
                 RemoveAura(aura);
                 it = alist.begin();
             }
@@ -11144,7 +11170,7 @@ void Unit::ApplyMaxPowerMod(Powers power, uint32 val, bool apply)
 
 void Unit::ApplyAuraProcTriggerDamage(Aura* aura, bool apply)
 {
-    AuraList& tAuraProcTriggerDamage = m_modAuras[SPELL_AURA_PROC_TRIGGER_DAMAGE];
+    AuraList& tAuraProcTriggerDamage = GetModAuraList(SPELL_AURA_PROC_TRIGGER_DAMAGE);
     if (apply)
         tAuraProcTriggerDamage.push_back(aura);
     else
@@ -12772,7 +12798,7 @@ void Unit::CleanupDeletedAuras()
     m_deletedHolders.clear();
 
     // really delete auras "deleted" while processing its ApplyModify code
-    for (AuraList::const_iterator itr = m_deletedAuras.begin(); itr != m_deletedAuras.end(); ++itr)
+    for (std::list<Aura*>::const_iterator itr = m_deletedAuras.begin(); itr != m_deletedAuras.end(); ++itr)
         delete *itr;
     m_deletedAuras.clear();
 }
@@ -1279,6 +1279,116 @@ enum PowerDefaults
 
 struct SpellProcEventEntry;                                 // used only privately
 
+// Auras of one type applied to a unit, stored contiguously.
+// Can be changed while iterated like the list it replaces: removed auras leave a hole, skipped
+// by the iterators, and added ones are appended. Holes are only compacted by Unit::Update.
+// The totals of the modifier amounts are kept until an aura is added, removed or its amount changed.
+class AuraTypeList
+{
+    public:
+        struct Totals
+        {
+            Totals() : modifier(0), multiplier(1.0f), maxPositive(0), maxNegative(0) {}
+
+            int32 modifier;                                 // sum of the amounts
+            float multiplier;                               // product of the (100 + amount) percents
+            int32 maxPositive;                              // 0 if no positive amount
+            int32 maxNegative;                              // 0 if no negative amount
+        };
+
+        struct MiscTotals : public Totals
+        {
+            explicit MiscTotals(int32 misc) : miscValue(misc) {}
+
+            int32 miscValue;
+        };
+
+        typedef std::vector<MiscTotals> MiscTotalsList;
+
+        class const_iterator
+        {
+            public:
+                typedef std::bidirectional_iterator_tag iterator_category;
+                typedef Aura* value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef Aura* const* pointer;
+                typedef Aura* const& reference;
+
+                const_iterator() : m_list(nullptr), m_index(0) {}
+                const_iterator(AuraTypeList const* list, size_t index) : m_list(list), m_index(index) { SkipHoles(); }
+
+                reference operator*() const { return m_list->m_auras[m_index]; }
+                pointer operator->() const { return &m_list->m_auras[m_index]; }
+
+                const_iterator& operator++() { ++m_index; SkipHoles(); return *this; }
+                const_iterator operator++(int) { const_iterator tmp = *this; ++*this; return tmp; }
+                const_iterator& operator--()
+                {
+                    do { --m_index; } while (m_index > 0 && !m_list->m_auras[m_index]);
+                    return *this;
+                }
+                const_iterator operator--(int) { const_iterator tmp = *this; --*this; return tmp; }
+
+                bool operator==(const_iterator const& other) const { return m_index == other.m_index; }
+                bool operator!=(const_iterator const& other) const { return m_index != other.m_index; }
+
+            private:
+                void SkipHoles() { while (m_index < m_list->m_auras.size() && !m_list->m_auras[m_index]) ++m_index; }
+
+                AuraTypeList const* m_list;
+                size_t m_index;
+        };
+
+        typedef const_iterator iterator;
+        typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+        typedef Aura* value_type;
+
+        AuraTypeList() : m_count(0), m_totalsValid(true) {}
+
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, m_auras.size()); }
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+        const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+        bool empty() const { return m_count == 0; }
+        size_t size() const { return m_count; }
+        Aura* front() const { return *begin(); }
+        Aura* back() const { return *rbegin(); }
+
+        void push_back(Aura* aura);
+        void remove(Aura* aura);
+
+        // must not be called while the list is iterated
+        void Compact()
+        {
+            if (m_count != m_auras.size())
+                m_auras.erase(std::remove(m_auras.begin(), m_auras.end(), nullptr), m_auras.end());
+        }
+
+        Totals const& GetTotals() const { if (!m_totalsValid) ComputeTotals(); return m_totals; }
+        // totals of the auras of each misc value, in the order the misc values were applied first
+        MiscTotalsList const& GetMiscTotals() const { if (!m_totalsValid) ComputeTotals(); return m_miscTotals; }
+        Totals const* GetMiscTotals(int32 miscValue) const
+        {
+            for (auto const& misc : GetMiscTotals())
+                if (misc.miscValue == miscValue)
+                    return &misc;
+            return nullptr;
+        }
+
+        void InvalidateTotals() { m_totalsValid = false; }
+
+    private:
+        void ComputeTotals() const;
+
+        std::vector<Aura*> m_auras;
+        uint32 m_count;
+
+        mutable bool m_totalsValid;
+        mutable Totals m_totals;
+        mutable MiscTotalsList m_miscTotals;
+};
+
 #define MAX_OBJECT_SLOT 5
 
 class Unit : public WorldObject
@@ -1289,7 +1399,7 @@ class Unit : public WorldObject
         typedef std::pair<SpellAuraHolderMap::iterator, SpellAuraHolderMap::iterator> SpellAuraHolderBounds;
         typedef std::pair<SpellAuraHolderMap::const_iterator, SpellAuraHolderMap::const_iterator> SpellAuraHolderConstBounds;
         typedef std::list<SpellAuraHolder*> SpellAuraHolderList;
-        typedef std::list<Aura*> AuraList;
+        typedef AuraTypeList AuraList;
         typedef std::list<DiminishingReturn> Diminishing;
         typedef std::set<uint32 /*playerGuidLow*/> ComboPointHolderSet;
         typedef std::map<uint8 /*slot*/, SpellAuraHolder* /*spellId*/> VisibleAuraMap;
@@ -2248,7 +2358,11 @@ class Unit : public WorldObject
 
         SpellAuraHolderMap&       GetSpellAuraHolderMap()       { return m_spellAuraHolders; }
         SpellAuraHolderMap const& GetSpellAuraHolderMap() const { return m_spellAuraHolders; }
-        AuraList const& GetAurasByType(AuraType type) const { return m_modAuras[type]; }
+        AuraList const& GetAurasByType(AuraType type) const
+        {
+            uint8 slot = m_modAurasSlot[type];
+            return slot ? *m_modAuras[slot - 1] : s_emptyAuraList;
+        }
         void ApplyAuraProcTriggerDamage(Aura* aura, bool apply);
 
         int32 GetTotalAuraModifier(AuraType auratype) const;
@@ -2503,7 +2617,7 @@ class Unit : public WorldObject
 
         SpellAuraHolderMap m_spellAuraHolders;
         SpellAuraHolderMap::iterator m_spellAuraHoldersUpdateIterator; // != end() in Unit::m_spellAuraHolders update and point to next element
-        AuraList m_deletedAuras;                            // auras removed while in ApplyModifier and waiting deleted
+        std::list<Aura*> m_deletedAuras;                    // auras removed while in ApplyModifier and waiting deleted
         SpellAuraHolderList m_deletedHolders;
 
         // Store Auras for which the target must be tracked
@@ -2518,7 +2632,11 @@ class Unit : public WorldObject
         bool m_isSorted;
         uint32 m_transform;
 
-        AuraList m_modAuras[TOTAL_AURAS];
+        // auras by type, only the types applied once to the unit have a list
+        uint8 m_modAurasSlot[TOTAL_AURAS];                  // index + 1 in m_modAuras, 0 if none
+        std::vector<std::unique_ptr<AuraList> > m_modAuras;
+        static AuraList const s_emptyAuraList;
+        AuraList& GetModAuraList(AuraType type);
         float m_auraModifiersGroup[UNIT_MOD_END][MODIFIER_TYPE_END];
         float m_weaponDamage[MAX_ATTACK][2];
         bool m_canModifyStats;
@@ -27,6 +27,66 @@
 #include "World/World.h"
 #include "Entities/ObjectGuid.h"
 
+#include <atomic>
+#include <chrono>
+
+namespace
+{
+    // deflate stream kept by each thread compressing packets, reset between packets instead of deflateInit/deflateEnd
+    struct DeflateContext
+    {
+        DeflateContext() : initialized(false), level(0)
+        {
+            stream.zalloc = (alloc_func)nullptr;
+            stream.zfree = (free_func)nullptr;
+            stream.opaque = (voidpf)nullptr;
+        }
+
+        ~DeflateContext()
+        {
+            if (initialized)
+                deflateEnd(&stream);
+        }
+
+        int Prepare(int newLevel)
+        {
+            if (!initialized)
+            {
+                int z_res = deflateInit(&stream, newLevel);
+                if (z_res == Z_OK)
+                {
+                    initialized = true;
+                    level = newLevel;
+                }
+                return z_res;
+            }
+
+            int z_res = deflateReset(&stream);
+            if (z_res != Z_OK || newLevel == level)
+                return z_res;
+
+            // nothing was fed since the reset, so changing the level does not flush anything
+            z_res = deflateParams(&stream, newLevel, Z_DEFAULT_STRATEGY);
+            if (z_res == Z_OK)
+                level = newLevel;
+            return z_res;
+        }
+
+        z_stream stream;
+        bool initialized;
+        int level;
+    };
+
+    thread_local DeflateContext t_deflateContext;
+
+    std::atomic<uint64> s_compressedPackets(0);
+    std::atomic<uint64> s_skippedPackets(0);
+    std::atomic<uint64> s_compressInputBytes(0);
+    std::atomic<uint64> s_compressOutputBytes(0);
+    std::atomic<uint64> s_compressTime(0);
+    std::atomic<uint64> s_compressMaxTime(0);
+}
+
 
 UpdateData::UpdateData(uint16 map) : m_blockCount(0), m_map(map)
 {
@@ -50,14 +110,11 @@ void UpdateData::AddUpdateBlock(const ByteBuffer& block)
 
 void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
 {
-    z_stream c_stream;
-
-    c_stream.zalloc = (alloc_func)nullptr;
-    c_stream.zfree = (free_func)nullptr;
-    c_stream.opaque = (voidpf)nullptr;
+    DeflateContext& context = t_deflateContext;
+    z_stream& c_stream = context.stream;
 
     // default Z_BEST_SPEED (1)
-    int z_res = deflateInit(&c_stream, sWorld.getConfig(CONFIG_UINT32_COMPRESSION));
+    int z_res = context.Prepare(sWorld.getConfig(CONFIG_UINT32_COMPRESSION));
     if (z_res != Z_OK)
     {
         sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
@@ -93,15 +150,60 @@ void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
         return;
     }
 
-    z_res = deflateEnd(&c_stream);
-    if (z_res != Z_OK)
+    *dst_size = c_stream.total_out;
+}
+
+bool UpdateData::IsCompressible(WorldPacket const& packet)
+{
+    if (packet.GetOpcode() != SMSG_UPDATE_OBJECT)
+        return false;
+
+    uint32 threshold = sWorld.getConfig(CONFIG_UINT32_COMPRESSION_THRESHOLD);
+    return threshold && packet.size() >= threshold;
+}
+
+bool UpdateData::CompressPacket(WorldPacket const& source, WorldPacket& packet)
+{
+    auto const startTime = std::chrono::steady_clock::now();
+
+    uint32 pSize = source.size();
+    uint32 destsize = compressBound(pSize);
+    packet.resize(destsize + sizeof(uint32));
+
+    packet.put<uint32>(0, pSize);
+    Compress(const_cast<uint8*>(packet.contents()) + sizeof(uint32), &destsize, (void*)source.contents(), pSize);
+
+    uint64 const elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+    s_compressTime += elapsed;
+    uint64 maxTime = s_compressMaxTime;
+    while (elapsed > maxTime && !s_compressMaxTime.compare_exchange_weak(maxTime, elapsed)) {}
+
+    // not worth it for data zlib can't shrink
+    if (destsize == 0 || destsize + sizeof(uint32) >= pSize)
     {
-        sLog.outError("Can't compress update packet (zlib: deflateEnd) Error code: %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
+        ++s_skippedPackets;
+        return false;
     }
 
-    *dst_size = c_stream.total_out;
+    packet.resize(destsize + sizeof(uint32));
+    packet.SetOpcode(SMSG_COMPRESSED_UPDATE_OBJECT);
+
+    ++s_compressedPackets;
+    s_compressInputBytes += pSize;
+    s_compressOutputBytes += packet.size();
+    return true;
+}
+
+UpdateCompressionStats UpdateData::GetCompressionStats()
+{
+    UpdateCompressionStats stats;
+    stats.packets = s_compressedPackets;
+    stats.skipped = s_skippedPackets;
+    stats.inputBytes = s_compressInputBytes;
+    stats.outputBytes = s_compressOutputBytes;
+    stats.totalTime = s_compressTime;
+    stats.maxTime = s_compressMaxTime;
+    return stats;
 }
 
 bool UpdateData::BuildPacket(WorldPacket& packet)
@@ -124,26 +226,9 @@ bool UpdateData::BuildPacket(WorldPacket& packet)
 
     buf.append(m_data);
 
-    size_t pSize = buf.wpos();                              // use real used data size
-
-    //if (pSize > 100)                                        // compress large packets
-    //{
-    //    uint32 destsize = compressBound(pSize);
-    //    packet.resize(destsize + sizeof(uint32));
-
-    //    packet.put<uint32>(0, pSize);
-    //    Compress(const_cast<uint8*>(packet->contents()) + sizeof(uint32), &destsize, (void*)buf.contents(), pSize);
-    //    if (destsize == 0)
-    //        return false;
-
-    //    packet.resize(destsize + sizeof(uint32));
-    //    packet.SetOpcode(SMSG_COMPRESSED_UPDATE_OBJECT);
-    //}
-    //else                                                    // send small packets without compression
-    {
-        packet.append(buf);
-        packet.SetOpcode(SMSG_UPDATE_OBJECT);
-    }
+    // large packets are compressed by the network thread sending them, see WorldSocket::SendPacket
+    packet.append(buf);
+    packet.SetOpcode(SMSG_UPDATE_OBJECT);
 
     return true;
 }
@@ -52,6 +52,17 @@ enum ObjectUpdateFlags
     UPDATEFLAG_UNK2                 = 0x4000,
 };
 
+/// Counters of SMSG_COMPRESSED_UPDATE_OBJECT compression, summed over all network threads
+struct UpdateCompressionStats
+{
+    uint64 packets;                                         ///< packets sent compressed
+    uint64 skipped;                                         ///< packets above threshold sent uncompressed (error or no gain)
+    uint64 inputBytes;                                      ///< uncompressed size of compressed packets
+    uint64 outputBytes;                                     ///< compressed size of compressed packets
+    uint64 totalTime;                                       ///< microseconds spent compressing
+    uint64 maxTime;
+};
+
 class UpdateData
 {
     public:
@@ -68,12 +79,18 @@ class UpdateData
 
         void SetMapId(uint16 mapId) { m_map = mapId; }
 
+        // SMSG_UPDATE_OBJECT big enough to be sent compressed (see config CompressionThreshold)
+        static bool IsCompressible(WorldPacket const& packet);
+        // build SMSG_COMPRESSED_UPDATE_OBJECT from SMSG_UPDATE_OBJECT, false if source must be sent as is
+        static bool CompressPacket(WorldPacket const& source, WorldPacket& packet);
+        static UpdateCompressionStats GetCompressionStats();
+
     protected:
         uint16 m_map;
         uint32 m_blockCount;
         GuidSet m_outOfRangeGUIDs;
         ByteBuffer m_data;
 
-        void Compress(void* dst, uint32* dst_size, void* src, int src_size);
+        static void Compress(void* dst, uint32* dst_size, void* src, int src_size);
 };
 #endif
@@ -446,6 +446,18 @@ void ObjectMgr::LoadPointOfInterestLocales()
     sLog.outString();
 }
 
+// script ids stored in snapshots are only valid for the same set of script names
+static std::string GetScriptNamesCacheKey()
+{
+    std::string key;
+    for (uint32 i = 1; i < sScriptDevAIMgr.GetScriptIdsCount(); ++i)
+    {
+        key += sScriptDevAIMgr.GetScriptName(i);
+        key += ';';
+    }
+    return key;
+}
+
 struct SQLCreatureLoader : public SQLStorageLoaderBase<SQLCreatureLoader, SQLStorage>
 {
     template<class D>
@@ -453,6 +465,8 @@ struct SQLCreatureLoader : public SQLStorageLoaderBase<SQLCreatureLoader, SQLSto
     {
         dst = D(sScriptDevAIMgr.GetScriptId(src));
     }
+
+    std::string GetCacheKey() const { return GetScriptNamesCacheKey(); }
 };
 
 void ObjectMgr::LoadCreatureTemplates()
@@ -1308,22 +1322,31 @@ void ObjectMgr::LoadCreatureModelRace()
     sLog.outString();
 }
 
+char const* ObjectMgr::GetLoadCreaturesQuery()
+{
+    //              0                       1   2    3
+    return "SELECT creature.guid, creature.id, map, modelid,"
+           //   4             5           6           7           8            9             10                   11           12
+           "equipment_id, position_x, position_y, position_z, orientation, spawntimesecsmin, spawntimesecsmax, spawndist, currentwaypoint,"
+           //   13         14       15          16            17         18         19
+           "curhealth, curmana, DeathState, MovementType, spawnMask, phaseMask, event,"
+           //   20                        21
+           "pool_creature.pool_entry, pool_creature_template.pool_entry "
+           "FROM creature "
+           "LEFT OUTER JOIN game_event_creature ON creature.guid = game_event_creature.guid "
+           "LEFT OUTER JOIN pool_creature ON creature.guid = pool_creature.guid "
+           "LEFT OUTER JOIN pool_creature_template ON creature.id = pool_creature_template.id";
+}
+
 void ObjectMgr::LoadCreatures()
 {
     uint32 count = 0;
-    //                                                0                       1   2    3
-    QueryResult* result = WorldDatabase.Query("SELECT creature.guid, creature.id, map, modelid,"
-                          //   4             5           6           7           8            9             10                   11           12
-                          "equipment_id, position_x, position_y, position_z, orientation, spawntimesecsmin, spawntimesecsmax, spawndist, currentwaypoint,"
-                          //   13         14       15          16            17         18         19
-                          "curhealth, curmana, DeathState, MovementType, spawnMask, phaseMask, event,"
-                          //   20                        21
-                          "pool_creature.pool_entry, pool_creature_template.pool_entry "
-                          "FROM creature "
-                          "LEFT OUTER JOIN game_event_creature ON creature.guid = game_event_creature.guid "
-                          "LEFT OUTER JOIN pool_creature ON creature.guid = pool_creature.guid "
-                          "LEFT OUTER JOIN pool_creature_template ON creature.id = pool_creature_template.id");
 
+    // prepared statement, the result rows are fetched already converted (binary protocol)
+    static SqlStatementID selCreatures;
+    SqlStatement stmt = WorldDatabase.CreateStatement(selCreatures, GetLoadCreaturesQuery());
+
+    QueryResult* result = stmt.Query();
     if (!result)
     {
         BarGoLink bar(1);
@@ -1965,6 +1988,8 @@ struct SQLItemLoader : public SQLStorageLoaderBase<SQLItemLoader, SQLStorage>
     {
         dst = D(sScriptDevAIMgr.GetScriptId(src));
     }
+
+    std::string GetCacheKey() const { return GetScriptNamesCacheKey(); }
 };
 
 void ObjectMgr::LoadItemPrototypes()
@@ -4928,6 +4953,8 @@ struct SQLInstanceLoader : public SQLStorageLoaderBase<SQLInstanceLoader, SQLSto
     {
         dst = D(sScriptDevAIMgr.GetScriptId(src));
     }
+
+    std::string GetCacheKey() const { return GetScriptNamesCacheKey(); }
 };
 
 void ObjectMgr::LoadInstanceTemplate()
@@ -4989,6 +5016,8 @@ struct SQLWorldLoader : public SQLStorageLoaderBase<SQLWorldLoader, SQLStorage>
     {
         dst = D(sScriptDevAIMgr.GetScriptId(src));
     }
+
+    std::string GetCacheKey() const { return GetScriptNamesCacheKey(); }
 };
 
 void ObjectMgr::LoadWorldTemplate()
@@ -6354,6 +6383,8 @@ struct SQLGameObjectLoader : public SQLStorageLoaderBase<SQLGameObjectLoader, SQ
     {
         dst = D(sScriptDevAIMgr.GetScriptId(src));
     }
+
+    std::string GetCacheKey() const { return GetScriptNamesCacheKey(); }
 };
 
 inline void CheckGOLockId(GameObjectInfo const* goInfo, uint32 dataN, uint32 N)
@@ -732,6 +732,8 @@ class ObjectMgr
         void LoadCreatureLocales();
         void LoadCreatureTemplates();
         void LoadCreatures();
+        // spawn query of LoadCreatures, also timed by .debug dbbench
+        static char const* GetLoadCreaturesQuery();
         void LoadCreatureAddons();
         void LoadCreatureClassLvlStats();
         void LoadCreatureModelInfo();
@@ -716,6 +716,7 @@ void Group::UpdateOfflineLeader(time_t time, uint32 delay)
 
 void Group::BroadcastPacket(WorldPacket const& packet, bool ignorePlayersInBGRaid, int group, ObjectGuid ignore)
 {
+    SharedPacketSender sender(packet);
     for (GroupReference* itr = GetFirstMember(); itr != nullptr; itr = itr->next())
     {
         Player* pl = itr->getSource();
@@ -723,7 +724,7 @@ void Group::BroadcastPacket(WorldPacket const& packet, bool ignorePlayersInBGRai
             continue;
 
         if (pl->GetSession() && (group == -1 || itr->getSubGroup() == group))
-            pl->GetSession()->SendPacket(packet);
+            sender.SendTo(pl->GetSession());
     }
 }
 
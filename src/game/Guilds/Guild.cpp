@@ -686,11 +686,12 @@ void Guild::BroadcastAddonToOfficers(WorldSession* session, const std::string& m
 
 void Guild::BroadcastPacket(WorldPacket const& packet)
 {
+    SharedPacketSender sender(packet);
     for (MemberList::const_iterator itr = members.begin(); itr != members.end(); ++itr)
     {
         Player* player = ObjectAccessor::FindPlayer(ObjectGuid(HIGHGUID_PLAYER, itr->first));
         if (player)
-            player->GetSession()->SendPacket(packet);
+            sender.SendTo(player->GetSession());
     }
 }
 
@@ -23,11 +23,15 @@
 #include "Server/DBCStores.h"
 #include "Maps/GridMap.h"
 #include "Vmap/VMapFactory.h"
+#include "Vmap/MapTree.h"
 #include "MotionGenerators/MoveMap.h"
 #include "World/World.h"
 #include "Policies/Singleton.h"
 #include "Util/Util.h"
 
+#include "Multithreading/TaskScheduler.h"
+
+#include <chrono>
 #include <mutex>
 
 char const* MAP_MAGIC         = "MAPS";
@@ -78,6 +82,16 @@ bool GridMap::loadData(char const* filename)
     // Unload old data if exist
     unloadData();
 
+    // use the file in place when its arrays are aligned, its pages are then shared by every instance and process using the grid
+    if (m_file.Open(filename))
+    {
+        if (mapData())
+            return true;
+
+        // written by an older extractor or bad file, read it below
+        unloadData();
+    }
+
     GridMapFileHeader header;
     // Not return error if file not found
     FILE* in = fopen(filename, "rb");
@@ -136,8 +150,127 @@ bool GridMap::loadData(char const* filename)
     return false;
 }
 
+bool GridMap::mapData()
+{
+    GridMapFileHeader const* header = m_file.GetAt<GridMapFileHeader>(0);
+    if (!header ||
+        header->mapMagic != *((uint32 const*)(MAP_MAGIC)) ||
+        header->versionMagic != *((uint32 const*)(MAP_VERSION_MAGIC)) ||
+        !IsAcceptableClientBuild(header->buildMagic))
+        return false;
+
+    if (header->areaMapOffset)
+    {
+        GridMapAreaHeader const* areaHeader = m_file.GetAt<GridMapAreaHeader>(header->areaMapOffset);
+        if (!areaHeader || areaHeader->fourcc != *((uint32 const*)(MAP_AREA_MAGIC)))
+            return false;
+
+        m_gridArea = areaHeader->gridArea;
+        if (!(areaHeader->flags & MAP_AREA_NO_AREA))
+        {
+            m_area_map = m_file.GetAt<uint16>(header->areaMapOffset + sizeof(GridMapAreaHeader), 16 * 16);
+            if (!m_area_map)
+                return false;
+        }
+    }
+
+    if (header->heightMapOffset)
+    {
+        GridMapHeightHeader const* heightHeader = m_file.GetAt<GridMapHeightHeader>(header->heightMapOffset);
+        if (!heightHeader || heightHeader->fourcc != *((uint32 const*)(MAP_HEIGHT_MAGIC)))
+            return false;
+
+        size_t const offset = header->heightMapOffset + sizeof(GridMapHeightHeader);
+        m_gridHeight = heightHeader->gridHeight;
+        if (!(heightHeader->flags & MAP_HEIGHT_NO_HEIGHT))
+        {
+            if ((heightHeader->flags & MAP_HEIGHT_AS_INT16))
+            {
+                m_uint16_V9 = m_file.GetAt<uint16>(offset, 129 * 129);
+                m_uint16_V8 = m_file.GetAt<uint16>(offset + sizeof(uint16) * 129 * 129, 128 * 128);
+                if (!m_uint16_V9 || !m_uint16_V8)
+                    return false;
+                m_gridIntHeightMultiplier = (heightHeader->gridMaxHeight - heightHeader->gridHeight) / 65535;
+                m_gridGetHeight = &GridMap::getHeightFromUint16;
+            }
+            else if ((heightHeader->flags & MAP_HEIGHT_AS_INT8))
+            {
+                m_uint8_V9 = m_file.GetAt<uint8>(offset, 129 * 129);
+                m_uint8_V8 = m_file.GetAt<uint8>(offset + sizeof(uint8) * 129 * 129, 128 * 128);
+                if (!m_uint8_V9 || !m_uint8_V8)
+                    return false;
+                m_gridIntHeightMultiplier = (heightHeader->gridMaxHeight - heightHeader->gridHeight) / 255;
+                m_gridGetHeight = &GridMap::getHeightFromUint8;
+            }
+            else
+            {
+                m_V9 = m_file.GetAt<float>(offset, 129 * 129);
+                m_V8 = m_file.GetAt<float>(offset + sizeof(float) * 129 * 129, 128 * 128);
+                if (!m_V9 || !m_V8)
+                    return false;
+                m_gridGetHeight = &GridMap::getHeightFromFloat;
+            }
+        }
+        else
+            m_gridGetHeight = &GridMap::getHeightFromFlat;
+    }
+
+    if (header->liquidMapOffset)
+    {
+        GridMapLiquidHeader const* liquidHeader = m_file.GetAt<GridMapLiquidHeader>(header->liquidMapOffset);
+        if (!liquidHeader || liquidHeader->fourcc != *((uint32 const*)(MAP_LIQUID_MAGIC)))
+            return false;
+
+        m_liquidType    = liquidHeader->liquidType;
+        m_liquid_offX   = liquidHeader->offsetX;
+        m_liquid_offY   = liquidHeader->offsetY;
+        m_liquid_width  = liquidHeader->width;
+        m_liquid_height = liquidHeader->height;
+        m_liquidLevel   = liquidHeader->liquidLevel;
+
+        size_t offset = header->liquidMapOffset + sizeof(GridMapLiquidHeader);
+        if (!(liquidHeader->flags & MAP_LIQUID_NO_TYPE))
+        {
+            m_liquidEntry = m_file.GetAt<uint16>(offset, 16 * 16);
+            m_liquidFlags = m_file.GetAt<uint8>(offset + sizeof(uint16) * 16 * 16, 16 * 16);
+            if (!m_liquidEntry || !m_liquidFlags)
+                return false;
+            offset += (sizeof(uint16) + sizeof(uint8)) * 16 * 16;
+        }
+
+        if (!(liquidHeader->flags & MAP_LIQUID_NO_HEIGHT))
+        {
+            m_liquid_map = m_file.GetAt<float>(offset, m_liquid_width * m_liquid_height);
+            if (!m_liquid_map)
+                return false;
+        }
+    }
+
+    if (header->holesOffset)
+    {
+        m_holes = m_file.GetAt<uint16>(header->holesOffset, 16 * 16);
+        if (!m_holes)
+            return false;
+    }
+
+    return true;
+}
+
 void GridMap::unloadData()
 {
+    if (m_file.IsOpen())
+    {
+        // nothing to free, the arrays point into the file
+        m_area_map = nullptr;
+        m_V9 = nullptr;
+        m_V8 = nullptr;
+        m_liquidEntry = nullptr;
+        m_liquidFlags = nullptr;
+        m_liquid_map = nullptr;
+        m_holes = nullptr;
+        m_file.Close();
+    }
+
     if (m_area_map)    { delete[] m_area_map;    m_area_map = nullptr; }
     if (m_V9)          { delete[] m_V9;          m_V9 = nullptr; }
     if (m_V8)          { delete[] m_V8;          m_V8 = nullptr; }
@@ -715,6 +848,9 @@ TerrainInfo::TerrainInfo(uint32 mapid) : m_mapId(mapid)
         {
             m_GridMaps[i][k] = nullptr;
             m_GridRef[i][k] = 0;
+            m_GridTilesLoaded[i][k] = false;
+            m_GridPrefetched[i][k] = false;
+            m_GridPrefetchQueued[i][k] = false;
         }
     }
 
@@ -747,7 +883,7 @@ GridMap* TerrainInfo::Load(const uint32 x, const uint32 y)
 
     // quick check if GridMap already loaded
     GridMap* pMap = m_GridMaps[x][y];
-    if (!pMap)
+    if (!pMap || !m_GridTilesLoaded[x][y])
         pMap = LoadMapAndVMap(x, y);
 
     return pMap;
@@ -776,6 +912,9 @@ void TerrainInfo::CleanUpGrids(const uint32 diff)
     if (!i_timer.Passed())
         return;
 
+    // grid prefetch threads may be loading meantime
+    LOCK_GUARD lock(m_mutex);
+
     for (int y = 0; y < MAX_NUMBER_OF_GRIDS; ++y)
     {
         for (int x = 0; x < MAX_NUMBER_OF_GRIDS; ++x)
@@ -783,6 +922,13 @@ void TerrainInfo::CleanUpGrids(const uint32 diff)
             const int16& iRef = m_GridRef[x][y];
             GridMap* pMap = m_GridMaps[x][y];
 
+            // give the player some time to reach a prefetched grid
+            if (m_GridPrefetched[x][y])
+            {
+                m_GridPrefetched[x][y] = false;
+                continue;
+            }
+
             // delete those GridMap objects which have refcount = 0
             if (pMap && iRef == 0)
             {
@@ -791,11 +937,16 @@ void TerrainInfo::CleanUpGrids(const uint32 diff)
                 pMap->unloadData();
                 delete pMap;
 
-                // unload VMAPS...
-                VMAP::VMapFactory::createOrGetVMapManager()->unloadMap(m_mapId, x, y);
+                if (m_GridTilesLoaded[x][y])
+                {
+                    m_GridTilesLoaded[x][y] = false;
+
+                    // unload VMAPS...
+                    VMAP::VMapFactory::createOrGetVMapManager()->unloadMap(m_mapId, x, y);
 
-                // unload mmap...
-                MMAP::MMapFactory::createOrGetMMapManager()->unloadMap(m_mapId, x, y);
+                    // unload mmap...
+                    MMAP::MMapFactory::createOrGetMMapManager()->unloadMap(m_mapId, x, y);
+                }
             }
         }
     }
@@ -1212,38 +1363,46 @@ GridMap* TerrainInfo::GetGrid(const float x, const float y)
 
     // quick check if GridMap already loaded
     GridMap* pMap = m_GridMaps[gx][gy];
-    if (!pMap)
+    if (!pMap || !m_GridTilesLoaded[gx][gy])
         pMap = LoadMapAndVMap(gx, gy);
 
     return pMap;
 }
 
+GridMap* TerrainInfo::LoadGridMap(const uint32 x, const uint32 y) const
+{
+    GridMap* map = new GridMap();
+
+    // map file name
+    int len = sWorld.GetDataPath().length() + strlen("maps/%03u%02u%02u.map") + 1;
+    char* tmp = new char[len];
+    snprintf(tmp, len, (char*)(sWorld.GetDataPath() + "maps/%03u%02u%02u.map").c_str(), m_mapId, x, y);
+    DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Loading map %s", tmp);
+
+    if (!map->loadData(tmp))
+    {
+        sLog.outError("Error load map file: \n %s\n", tmp);
+        // ASSERT(false);
+    }
+
+    delete[] tmp;
+    return map;
+}
+
 GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y)
 {
     // double checked lock pattern
-    if (!m_GridMaps[x][y])
+    if (!m_GridMaps[x][y] || !m_GridTilesLoaded[x][y])
     {
         LOCK_GUARD lock(m_mutex);
 
         if (!m_GridMaps[x][y])
-        {
-            GridMap* map = new GridMap();
+            m_GridMaps[x][y] = LoadGridMap(x, y);
 
-            // map file name
-            int len = sWorld.GetDataPath().length() + strlen("maps/%03u%02u%02u.map") + 1;
-            char* tmp = new char[len];
-            snprintf(tmp, len, (char*)(sWorld.GetDataPath() + "maps/%03u%02u%02u.map").c_str(), m_mapId, x, y);
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Loading map %s", tmp);
-
-            if (!map->loadData(tmp))
-            {
-                sLog.outError("Error load map file: \n %s\n", tmp);
-                // ASSERT(false);
-            }
-
-            delete[] tmp;
-            m_GridMaps[x][y] = map;
+        m_GridPrefetched[x][y] = false;
 
+        if (!m_GridTilesLoaded[x][y])
+        {
             // load VMAPs for current map/grid...
             const MapEntry* i_mapEntry = sMapStore.LookupEntry(m_mapId);
             const char* mapName = i_mapEntry ? i_mapEntry->name[sWorld.GetDefaultDbcLocale()] : "UNNAMEDMAP\x0";
@@ -1264,12 +1423,75 @@ GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y)
 
             // load navmesh
             MMAP::MMapFactory::createOrGetMMapManager()->loadMap(m_mapId, x, y);
+
+            m_GridTilesLoaded[x][y] = true;
         }
     }
 
     return  m_GridMaps[x][y];
 }
 
+bool TerrainInfo::SetPrefetchQueued(const uint32 x, const uint32 y)
+{
+    LOCK_GUARD lock(m_mutex);
+
+    if (m_GridMaps[x][y] || m_GridPrefetchQueued[x][y])
+        return false;
+
+    m_GridPrefetchQueued[x][y] = true;
+    return true;
+}
+
+// read a file to have it in the system file cache when it is loaded for real
+static void ReadFileToCache(std::string const& fileName)
+{
+    FILE* file = fopen(fileName.c_str(), "rb");
+    if (!file)
+        return;
+
+    char buffer[64 * 1024];
+    while (fread(buffer, 1, sizeof(buffer), file) == sizeof(buffer)) {}
+    fclose(file);
+}
+
+void TerrainInfo::PrefetchGrid(const uint32 x, const uint32 y)
+{
+    // load outside of the lock, map threads may need other grids of the terrain meantime
+    GridMap* map = LoadGridMap(x, y);
+
+    {
+        LOCK_GUARD lock(m_mutex);
+
+        m_GridPrefetchQueued[x][y] = false;
+        if (!m_GridMaps[x][y])
+        {
+            m_GridMaps[x][y] = map;
+            m_GridPrefetched[x][y] = true;
+            map = nullptr;
+        }
+    }
+
+    // loaded meantime by a map
+    if (map)
+    {
+        map->unloadData();
+        delete map;
+        return;
+    }
+
+    // the map file is only mapped by the load, fault its pages in now
+    char mapFile[32];
+    snprintf(mapFile, sizeof(mapFile), "maps/%03u%02u%02u.map", m_mapId, x, y);
+    ReadFileToCache(sWorld.GetDataPath() + mapFile);
+
+    // vmap and mmap managers are not thread safe, their tiles are loaded by the map at grid creation
+    ReadFileToCache(sWorld.GetDataPath() + "vmaps/" + VMAP::StaticMapTree::getTileFileName(m_mapId, x, y));
+
+    char mmapTile[32];
+    snprintf(mmapTile, sizeof(mmapTile), "mmaps/%03u%02u%02u.mmtile", m_mapId, x, y);
+    ReadFileToCache(sWorld.GetDataPath() + mmapTile);
+}
+
 float TerrainInfo::GetWaterLevel(float x, float y, float z, float* pGround /*= nullptr*/) const
 {
     if (const_cast<TerrainInfo*>(this)->GetGrid(x, y))
@@ -1341,8 +1563,20 @@ void TerrainManager::UnloadTerrain(const uint32 mapId)
     }
 }
 
+static std::mutex s_releasedTerrainsLock;
+static std::vector<uint32> s_releasedTerrains;              // last reference dropped by a grid prefetch task
+
 void TerrainManager::Update(const uint32 diff)
 {
+    // unload terrains of maps destroyed while a prefetch task still held them
+    std::vector<uint32> releasedTerrains;
+    {
+        std::lock_guard<std::mutex> guard(s_releasedTerrainsLock);
+        releasedTerrains.swap(s_releasedTerrains);
+    }
+    for (uint32 mapId : releasedTerrains)
+        UnloadTerrain(mapId);
+
     // global garbage collection for GridMap objects and VMaps
     for (TerrainDataMap::iterator iter = i_TerrainMap.begin(); iter != i_TerrainMap.end(); ++iter)
         iter->second->CleanUpGrids(diff);
@@ -1356,6 +1590,89 @@ void TerrainManager::UnloadAll()
     i_TerrainMap.clear();
 }
 
+static MaNGOS::TaskScheduler s_gridPrefetchWorkers;
+static std::mutex s_gridLoadStatsLock;
+static GridLoadStats s_gridLoadStats;
+
+void TerrainManager::StartPrefetchWorkers(uint32 threads)
+{
+    if (!threads)
+        return;
+
+    s_gridPrefetchWorkers.Start(threads);
+    sLog.outString("Grid prefetching: using %u threads", threads);
+}
+
+void TerrainManager::StopPrefetchWorkers()
+{
+    s_gridPrefetchWorkers.Stop();
+}
+
+bool TerrainManager::IsPrefetchEnabled()
+{
+    return s_gridPrefetchWorkers.IsRunning();
+}
+
+void TerrainManager::PrefetchGrid(TerrainInfo* terrain, uint32 x, uint32 y)
+{
+    MANGOS_ASSERT(x < MAX_NUMBER_OF_GRIDS);
+    MANGOS_ASSERT(y < MAX_NUMBER_OF_GRIDS);
+
+    if (!IsPrefetchEnabled() || !terrain->SetPrefetchQueued(x, y))
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(s_gridLoadStatsLock);
+        ++s_gridLoadStats.prefetchQueued;
+    }
+
+    // the terrain must survive its maps until the task is done
+    terrain->AddRef();
+    s_gridPrefetchWorkers.Submit([terrain, x, y]()
+    {
+        std::chrono::steady_clock::time_point const startTime = std::chrono::steady_clock::now();
+        terrain->PrefetchGrid(x, y);
+        uint64 const time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+
+        {
+            std::lock_guard<std::mutex> guard(s_gridLoadStatsLock);
+            ++s_gridLoadStats.prefetchDone;
+            s_gridLoadStats.prefetchTime += time;
+        }
+
+        // the maps are gone, the terrain is unloaded by the world thread in TerrainManager::Update
+        if (terrain->Release())
+        {
+            std::lock_guard<std::mutex> guard(s_releasedTerrainsLock);
+            s_releasedTerrains.push_back(terrain->GetMapId());
+        }
+    });
+}
+
+void TerrainManager::AddTerrainLoadStats(bool cached, uint64 time)
+{
+    std::lock_guard<std::mutex> guard(s_gridLoadStatsLock);
+    ++s_gridLoadStats.loads;
+    if (cached)
+        ++s_gridLoadStats.terrainCached;
+    s_gridLoadStats.terrainTime += time;
+    s_gridLoadStats.maxTerrainTime = std::max(s_gridLoadStats.maxTerrainTime, time);
+}
+
+void TerrainManager::AddObjectLoadStats(uint64 time)
+{
+    std::lock_guard<std::mutex> guard(s_gridLoadStatsLock);
+    ++s_gridLoadStats.objectLoads;
+    s_gridLoadStats.objectTime += time;
+    s_gridLoadStats.maxObjectTime = std::max(s_gridLoadStats.maxObjectTime, time);
+}
+
+GridLoadStats TerrainManager::GetGridLoadStats()
+{
+    std::lock_guard<std::mutex> guard(s_gridLoadStatsLock);
+    return s_gridLoadStats;
+}
+
 uint32 TerrainManager::GetAreaIdByAreaFlag(uint16 areaflag, uint32 map_id)
 {
     AreaTableEntry const* entry = GetAreaEntryByAreaFlagAndMap(areaflag, map_id);
@@ -22,6 +22,7 @@
 #include "Platform/Define.h"
 #include "Policies/Singleton.h"
 #include "Maps/GridDefines.h"
+#include "Util/MappedFile.h"
 
 #include <atomic>
 #include <mutex>
@@ -151,6 +152,10 @@ class GridMap
 
         uint16* m_holes;
 
+        // when loaded in place the arrays above point into the mapped file
+        MappedFile m_file;
+
+        bool mapData();
         bool loadAreaData(FILE* in, uint32 offset, uint32 size);
         bool loadHeightData(FILE* in, uint32 offset, uint32 size);
         bool loadGridMapLiquidData(FILE* in, uint32 offset, uint32 size);
@@ -238,6 +243,11 @@ class TerrainInfo : public Referencable<std::atomic_long>
         bool GetAreaInfo(float x, float y, float z, uint32& mogpflags, int32& adtId, int32& rootId, int32& groupId) const;
         bool IsOutdoors(float x, float y, float z) const;
 
+        // load the GridMap of a grid before it is needed and read its vmap/mmap tiles into the system file cache,
+        // called on a grid prefetch thread, see TerrainManager::PrefetchGrid
+        void PrefetchGrid(const uint32 x, const uint32 y);
+        bool IsGridMapLoaded(const uint32 x, const uint32 y) const { return m_GridMaps[x][y] != nullptr; }
+
         // this method should be used only by TerrainManager
         // to cleanup unreferenced GridMap objects - they are too heavy
         // to destroy them dynamically, especially on highly populated servers
@@ -256,6 +266,10 @@ class TerrainInfo : public Referencable<std::atomic_long>
 
         GridMap* GetGrid(const float x, const float y);
         GridMap* LoadMapAndVMap(const uint32 x, const uint32 y);
+        GridMap* LoadGridMap(const uint32 x, const uint32 y) const;
+
+        friend class TerrainManager;
+        bool SetPrefetchQueued(const uint32 x, const uint32 y);
 
         int RefGrid(const uint32& x, const uint32& y);
         int UnrefGrid(const uint32& x, const uint32& y);
@@ -265,6 +279,12 @@ class TerrainInfo : public Referencable<std::atomic_long>
         GridMap* m_GridMaps[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
         int16 m_GridRef[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
 
+        // vmap and mmap tiles are loaded, GridMap can be loaded before them by prefetching
+        bool m_GridTilesLoaded[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
+        // prefetched GridMap not used yet, kept one more clean up interval
+        bool m_GridPrefetched[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
+        bool m_GridPrefetchQueued[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
+
         // global garbage collection timer
         ShortIntervalTimer i_timer;
 
@@ -274,6 +294,24 @@ class TerrainInfo : public Referencable<std::atomic_long>
         LOCK_TYPE m_refMutex;
 };
 
+/// Grid creations by maps, times in microseconds
+struct GridLoadStats
+{
+    GridLoadStats() : loads(0), terrainCached(0), terrainTime(0), maxTerrainTime(0), objectLoads(0), objectTime(0), maxObjectTime(0),
+        prefetchQueued(0), prefetchDone(0), prefetchTime(0) {}
+
+    uint64 loads;
+    uint64 terrainCached;                                   // GridMap was already loaded (prefetched or used by another instance)
+    uint64 terrainTime;                                     // of TerrainInfo::Load in world/map threads
+    uint64 maxTerrainTime;
+    uint64 objectLoads;
+    uint64 objectTime;                                      // of creature and gameobject spawning
+    uint64 maxObjectTime;
+    uint64 prefetchQueued;
+    uint64 prefetchDone;                                    // prefetch tasks run, the grid may have been loaded by its map meantime
+    uint64 prefetchTime;
+};
+
 // class for managing TerrainData object and all sort of geometry querying operations
 class TerrainManager : public MaNGOS::Singleton<TerrainManager, MaNGOS::ClassLevelLockable<TerrainManager, std::mutex> >
 {
@@ -287,6 +325,17 @@ class TerrainManager : public MaNGOS::Singleton<TerrainManager, MaNGOS::ClassLev
         void Update(const uint32 diff);
         void UnloadAll();
 
+        // grid prefetch threads, prefetching is disabled without threads
+        static void StartPrefetchWorkers(uint32 threads);
+        static void StopPrefetchWorkers();
+        static bool IsPrefetchEnabled();
+        // queue TerrainInfo::PrefetchGrid, nothing done if the GridMap is loaded or queued already
+        static void PrefetchGrid(TerrainInfo* terrain, uint32 x, uint32 y);
+
+        static void AddTerrainLoadStats(bool cached, uint64 time);
+        static void AddObjectLoadStats(uint64 time);
+        static GridLoadStats GetGridLoadStats();
+
         uint16 GetAreaFlag(uint32 mapid, float x, float y, float z) const
         {
             TerrainInfo* pData = const_cast<TerrainManager*>(this)->LoadTerrain(mapid);
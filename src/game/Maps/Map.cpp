@@ -40,6 +40,9 @@
 #include "Weather/Weather.h"
 #include "Grids/ObjectGridLoader.h"
 #include "Util/UniqueTrackablePtr.h"
+#include "Server/DBCStores.h"
+
+#include <chrono>
 
 #ifdef BUILD_ELUNA
 #include "LuaEngine/LuaEngine.h"
@@ -89,8 +92,58 @@ void Map::LoadMapAndVMap(int gx, int gy)
     if (m_bLoadedGrids[gx][gy])
         return;
 
+    std::chrono::steady_clock::time_point const startTime = std::chrono::steady_clock::now();
+    bool const cached = m_TerrainData->IsGridMapLoaded(gx, gy);
+
     if (m_TerrainData->Load(gx, gy))
         m_bLoadedGrids[gx][gy] = true;
+
+    TerrainManager::AddTerrainLoadStats(cached, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count());
+}
+
+void Map::PrefetchGrid(float x, float y)
+{
+    if (!MaNGOS::IsValidMapCoord(x, y))
+        return;
+
+    // created grids have their terrain loaded
+    GridPair p = MaNGOS::ComputeGridPair(x, y);
+    if (getNGrid(p.x_coord, p.y_coord))
+        return;
+
+    TerrainManager::PrefetchGrid(m_TerrainData, (MAX_NUMBER_OF_GRIDS - 1) - p.x_coord, (MAX_NUMBER_OF_GRIDS - 1) - p.y_coord);
+}
+
+void Map::PrefetchGridsAhead(Player const* player)
+{
+    // seconds of movement to look ahead, grids are created when they enter visibility range
+    float const lookAhead = 10.0f;
+
+    if (!TerrainManager::IsPrefetchEnabled())
+        return;
+
+    float const speed = player->GetSpeed(player->IsTaxiFlying() || player->IsFlying() ? MOVE_FLIGHT : MOVE_RUN);
+    float const distance = GetVisibilityDistance() + speed * lookAhead;
+    float const angle = player->GetOrientation();
+
+    PrefetchGrid(player->GetPositionX() + distance * cos(angle), player->GetPositionY() + distance * sin(angle));
+}
+
+void Map::PrefetchTaxiPathGrids(uint32 path, uint32 pathNode)
+{
+    // flight distance to prefetch at departure, next grids are prefetched while flying
+    float const lookAhead = 2 * SIZE_OF_GRIDS;
+
+    if (!TerrainManager::IsPrefetchEnabled() || path >= sTaxiPathNodesByPath.size())
+        return;
+
+    TaxiPathNodeList const& nodes = sTaxiPathNodesByPath[path];
+    float distance = 0.0f;
+    for (uint32 i = pathNode + 1; i < nodes.size() && nodes[i]->mapid == i_id && distance < lookAhead; ++i)
+    {
+        distance += sqrt((nodes[i]->x - nodes[i - 1]->x) * (nodes[i]->x - nodes[i - 1]->x) + (nodes[i]->y - nodes[i - 1]->y) * (nodes[i]->y - nodes[i - 1]->y));
+        PrefetchGrid(nodes[i]->x, nodes[i]->y);
+    }
 }
 
 Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode)
@@ -299,8 +352,10 @@ bool Map::EnsureGridLoaded(const Cell& cell)
         // active object A(loaded with loader.LoadN call and added to the  map)
         // summons some active object B, while B added to map grid loading called again and so on..
         setGridObjectDataLoaded(true, cell.GridX(), cell.GridY());
+        std::chrono::steady_clock::time_point const startTime = std::chrono::steady_clock::now();
         ObjectGridLoader loader(*grid, this, cell);
         loader.LoadN();
+        TerrainManager::AddObjectLoadStats(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count());
 
         // Add resurrectable corpses to world object list in grid
         sObjectAccessor.AddCorpsesToGrid(GridPair(cell.GridX(), cell.GridY()), (*grid)(cell.CellX(), cell.CellY()), this);
@@ -323,6 +378,8 @@ void Map::ForceLoadGrid(float x, float y)
 
 bool Map::Add(Player* player)
 {
+    AssertThreadAccess();
+
     player->GetMapRef().link(this, player);
     player->SetMap(this);
 
@@ -358,6 +415,7 @@ void
 Map::Add(T* obj)
 {
     MANGOS_ASSERT(obj);
+    AssertThreadAccess();
 
     CellPair p = MaNGOS::ComputeCellPair(obj->GetPositionX(), obj->GetPositionY());
     if (p.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || p.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
@@ -510,6 +568,7 @@ void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<MaNGOS::Obje
 void Map::Update(const uint32& t_diff)
 {
     m_dyn_tree.update(t_diff);
+    ClearLineOfSightCache();
 
     /// update worldsessions for existing players
     for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
@@ -538,14 +597,6 @@ void Map::Update(const uint32& t_diff)
     /// update active cells around players and active objects
     resetMarkedCells();
 
-    {
-        std::lock_guard<std::mutex> guard(m_messageMutex);
-        for (auto& message : m_messageVector)
-            message(this);
-
-        m_messageVector.clear();
-    }
-
     MaNGOS::ObjectUpdater updater(t_diff);
     // for creature
     TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
@@ -644,6 +695,8 @@ void Map::Update(const uint32& t_diff)
 
 void Map::Remove(Player* player, bool remove)
 {
+    AssertThreadAccess();
+
 #ifdef BUILD_ELUNA
     if (Eluna* e = GetEluna())
         e->OnPlayerLeave(this, player);
@@ -703,6 +756,8 @@ template<class T>
 void
 Map::Remove(T* obj, bool remove)
 {
+    AssertThreadAccess();
+
     CellPair p = MaNGOS::ComputeCellPair(obj->GetPositionX(), obj->GetPositionY());
     if (p.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || p.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
     {
@@ -770,6 +825,8 @@ Map::PlayerRelocation(Player* player, float x, float y, float z, float orientati
 
         NGridType* newGrid = getNGrid(new_cell.GridX(), new_cell.GridY());
         player->GetViewPoint().Event_GridChanged(&(*newGrid)(new_cell.CellX(), new_cell.CellY()));
+
+        PrefetchGridsAhead(player);
     }
 
     player->OnRelocated();
@@ -1855,6 +1912,7 @@ Player* Map::GetPlayer(ObjectGuid guid)
  */
 Creature* Map::GetCreature(ObjectGuid guid)
 {
+    AssertThreadAccess();
     return m_objectsStore.find<Creature>(guid, (Creature*)nullptr);
 }
 
@@ -1865,6 +1923,7 @@ Creature* Map::GetCreature(ObjectGuid guid)
  */
 Pet* Map::GetPet(ObjectGuid guid)
 {
+    AssertThreadAccess();
     return m_objectsStore.find<Pet>(guid, (Pet*)nullptr);
 }
 
@@ -1906,6 +1965,7 @@ Creature* Map::GetAnyTypeCreature(ObjectGuid guid)
  */
 GameObject* Map::GetGameObject(ObjectGuid guid)
 {
+    AssertThreadAccess();
     return m_objectsStore.find<GameObject>(guid, (GameObject*)nullptr);
 }
 
@@ -1916,6 +1976,7 @@ GameObject* Map::GetGameObject(ObjectGuid guid)
  */
 DynamicObject* Map::GetDynamicObject(ObjectGuid guid)
 {
+    AssertThreadAccess();
     return m_objectsStore.find<DynamicObject>(guid, (DynamicObject*)nullptr);
 }
 
@@ -2107,8 +2168,58 @@ void Map::PlayDirectSoundToMap(uint32 soundId, uint32 zoneId /*=0*/) const
  */
 bool Map::IsInLineOfSight(float srcX, float srcY, float srcZ, float destX, float destY, float destZ, uint32 phasemask) const
 {
-    return VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, destX, destY, destZ)
-           && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ, phasemask);
+    LineOfSightRay ray(srcX, srcY, srcZ, destX, destY, destZ, phasemask);
+    auto itr = m_lineOfSightCache.find(ray);
+    if (itr != m_lineOfSightCache.end())
+        return itr->second;
+
+    bool result = VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, destX, destY, destZ)
+                  && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ, phasemask);
+
+    if (m_lineOfSightCache.size() >= MAX_LOS_CACHE_SIZE)
+        m_lineOfSightCache.clear();
+    m_lineOfSightCache.emplace(ray, result);
+    return result;
+}
+
+/**
+ * Same as above for many rays, the ones not known yet are tested against the static tree in one batch
+ */
+void Map::IsInLineOfSight(std::vector<LineOfSightRay>& rays) const
+{
+    std::vector<VMAP::LineOfSightQuery> queries;
+    std::vector<LineOfSightRay*> queried;
+    queries.reserve(rays.size());
+    queried.reserve(rays.size());
+
+    for (LineOfSightRay& ray : rays)
+    {
+        auto itr = m_lineOfSightCache.find(ray);
+        if (itr != m_lineOfSightCache.end())
+        {
+            ray.result = itr->second;
+            continue;
+        }
+
+        queries.push_back({ ray.srcX, ray.srcY, ray.srcZ, ray.destX, ray.destY, ray.destZ, true });
+        queried.push_back(&ray);
+    }
+
+    if (queries.empty())
+        return;
+
+    VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), queries);
+
+    if (m_lineOfSightCache.size() + queried.size() > MAX_LOS_CACHE_SIZE)
+        m_lineOfSightCache.clear();
+
+    for (size_t i = 0; i < queried.size(); ++i)
+    {
+        LineOfSightRay& ray = *queried[i];
+        ray.result = queries[i].result
+                     && m_dyn_tree.isInLineOfSight(ray.srcX, ray.srcY, ray.srcZ, ray.destX, ray.destY, ray.destZ, ray.phasemask);
+        m_lineOfSightCache.emplace(ray, ray.result);
+    }
 }
 
 /**
@@ -2206,11 +2317,13 @@ float Map::GetHeight(uint32 phasemask, float x, float y, float z) const
 void Map::InsertGameObjectModel(const GameObjectModel& mdl)
 {
     m_dyn_tree.insert(mdl);
+    ClearLineOfSightCache();
 }
 
 void Map::RemoveGameObjectModel(const GameObjectModel& mdl)
 {
     m_dyn_tree.remove(mdl);
+    ClearLineOfSightCache();
 }
 
 bool Map::ContainsGameObjectModel(const GameObjectModel& mdl) const
@@ -2396,6 +2509,30 @@ void Map::AddMessage(const std::function<void(Map*)>& message)
     m_messageVector.push_back(message);
 }
 
+static thread_local Map* t_updatingMap = nullptr;
+
+Map* Map::GetUpdatingMap()
+{
+    return t_updatingMap;
+}
+
+void Map::SetUpdatingMap(Map* map)
+{
+    t_updatingMap = map;
+}
+
+void Map::ProcessMessages()
+{
+    std::vector<std::function<void(Map*)>> messageVectorCopy;
+    {
+        std::lock_guard<std::mutex> guard(m_messageMutex);
+        std::swap(m_messageVector, messageVectorCopy);
+    }
+
+    for (auto& message : messageVectorCopy)
+        message(this);
+}
+
 bool Map::IsMountAllowed() const
 {
     if (!IsDungeon())
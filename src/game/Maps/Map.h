@@ -99,6 +99,37 @@ enum LevelRequirementVsMode
 #endif
 
 #define MIN_UNLOAD_DELAY      1                             // immediate unload
+#define MAX_LOS_CACHE_SIZE    4096                          // line of sight results kept during one map update
+
+struct LineOfSightRay
+{
+    LineOfSightRay() : srcX(0.0f), srcY(0.0f), srcZ(0.0f), destX(0.0f), destY(0.0f), destZ(0.0f), phasemask(0), result(true) {}
+    LineOfSightRay(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phase) :
+        srcX(x1), srcY(y1), srcZ(z1), destX(x2), destY(y2), destZ(z2), phasemask(phase), result(true) {}
+
+    // result is not part of the key
+    bool operator==(LineOfSightRay const& other) const
+    {
+        return srcX == other.srcX && srcY == other.srcY && srcZ == other.srcZ &&
+               destX == other.destX && destY == other.destY && destZ == other.destZ && phasemask == other.phasemask;
+    }
+
+    float srcX, srcY, srcZ;
+    float destX, destY, destZ;
+    uint32 phasemask;
+    bool result;
+};
+
+struct LineOfSightRayHash
+{
+    size_t operator()(LineOfSightRay const& ray) const
+    {
+        size_t hash = std::hash<uint32>()(ray.phasemask);
+        for (float coord : { ray.srcX, ray.srcY, ray.srcZ, ray.destX, ray.destY, ray.destZ })
+            hash = hash * 31 + std::hash<float>()(coord);
+        return hash;
+    }
+};
 
 class Map : public GridRefManager<NGridType>
 {
@@ -160,6 +191,10 @@ class Map : public GridRefManager<NGridType>
         bool GetUnloadLock(const GridPair& p) const { return getNGrid(p.x_coord, p.y_coord)->getUnloadLock(); }
         void SetUnloadLock(const GridPair& p, bool on) { getNGrid(p.x_coord, p.y_coord)->setUnloadExplicitLock(on); }
         void ForceLoadGrid(float x, float y);
+
+        // queue terrain loading of the grids a moving player or a taxi flight is about to reach
+        void PrefetchGridsAhead(Player const* player);
+        void PrefetchTaxiPathGrids(uint32 path, uint32 pathNode);
         bool UnloadGrid(const uint32& x, const uint32& y, bool pForce);
         virtual void UnloadAll(bool pForce);
 
@@ -294,6 +329,10 @@ class Map : public GridRefManager<NGridType>
         float GetHeight(uint32 phasemask, float x, float y, float z) const;
         bool GetHeightInRange(uint32 phasemask, float x, float y, float& z, float maxSearchDist = 4.0f) const;
         bool IsInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phasemask) const;
+        // fill the result of every ray, the static tree is walked once for rays close to each other
+        void IsInLineOfSight(std::vector<LineOfSightRay>& rays) const;
+        // results are kept until the next update or until the dynamic tree changes
+        void ClearLineOfSightCache() { m_lineOfSightCache.clear(); }
         bool GetHitPosition(float srcX, float srcY, float srcZ, float& destX, float& destY, float& destZ, uint32 phasemask, float modifyDist) const;
 
         // Object Model insertion/remove/test for dynamic vmaps use
@@ -323,7 +362,21 @@ class Map : public GridRefManager<NGridType>
         bool GetRandomPointInTheAir(uint32 phaseMask, float& x, float& y, float& z, float radius);
         bool GetRandomPointUnderWater(uint32 phaseMask, float& x, float& y, float& z, float radius, GridMapLiquidData& liquid_status);
 
+        // Queue work that has to run on this map from outside of its own update (other maps, world thread, network)
+        // Messages are executed by MapManager after all maps finished their update, so it is safe to use
+        // them for cross-map work (teleports, ObjectAccessor lookups, sWorld globals) while maps update in parallel
         void AddMessage(const std::function<void(Map*)>& message);
+        void ProcessMessages();
+
+        // map updated by the calling thread during parallel map updates, nullptr in any other thread
+        static Map* GetUpdatingMap();
+        static void SetUpdatingMap(Map* map);
+        // debug builds check that a map updating thread only accesses its own map
+#ifdef MANGOS_DEBUG
+        void AssertThreadAccess() const { MANGOS_ASSERT(!GetUpdatingMap() || GetUpdatingMap() == this); }
+#else
+        void AssertThreadAccess() const {}
+#endif
 
         uint32 SpawnedCountForEntry(uint32 entry);
         void AddToSpawnCount(const ObjectGuid & guid);
@@ -341,6 +394,7 @@ class Map : public GridRefManager<NGridType>
 
     private:
         void LoadMapAndVMap(int gx, int gy);
+        void PrefetchGrid(float x, float y);
 
         void SetTimer(uint32 t) { i_gridExpiry = t < MIN_GRID_DELAY ? MIN_GRID_DELAY : t; }
 
@@ -435,6 +489,7 @@ class Map : public GridRefManager<NGridType>
 
         // Dynamic Map tree object
         DynamicMapTree m_dyn_tree;
+        mutable std::unordered_map<LineOfSightRay, bool, LineOfSightRayHash> m_lineOfSightCache;
 
         // WeatherSystem
         WeatherSystem* m_weatherSystem;
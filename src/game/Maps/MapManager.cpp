@@ -55,6 +55,9 @@ void
 MapManager::Initialize()
 {
     InitStateMachine();
+
+    if (uint32 numThreads = sWorld.getConfig(CONFIG_UINT32_MAP_UPDATE_THREADS))
+        m_updater.Activate(numThreads);
 }
 
 void MapManager::InitStateMachine()
@@ -179,8 +182,22 @@ void MapManager::Update(uint32 diff)
     if (!i_timer.Passed())
         return;
 
+    if (m_updater.IsActive())
+    {
+        for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
+            m_updater.ScheduleUpdate(*iter->second, (uint32)i_timer.GetCurrent());
+
+        m_updater.Wait();
+    }
+    else
+    {
+        for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
+            iter->second->Update((uint32)i_timer.GetCurrent());
+    }
+
+    // cross-map work queued during the update is applied only now, when no map is updating
     for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
-        iter->second->Update((uint32)i_timer.GetCurrent());
+        iter->second->ProcessMessages();
 
     for (TransportSet::iterator iter = m_Transports.begin(); iter != m_Transports.end(); ++iter)
     {
@@ -231,6 +248,8 @@ bool MapManager::IsValidMAP(uint32 mapid)
 
 void MapManager::UnloadAll()
 {
+    m_updater.Deactivate();
+
     for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
         iter->second->UnloadAll(true);
 
@@ -23,6 +23,7 @@
 #include "Platform/Define.h"
 #include "Policies/Singleton.h"
 #include "Maps/Map.h"
+#include "Maps/MapUpdater.h"
 #include "Grids/GridStates.h"
 #include "Util/UniqueTrackablePtr.h"
 
@@ -71,6 +72,9 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
         void Initialize(void);
         void Update(uint32);
 
+        // maps are updated by several threads at once (MapUpdateThreads)
+        bool IsUpdatingInParallel() const { return m_updater.IsActive(); }
+
         void SetGridCleanUpDelay(uint32 t)
         {
             if (t < MIN_GRID_DELAY)
@@ -165,6 +169,7 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
         uint32 i_gridCleanUpDelay;
         MapMapType i_maps;
         IntervalTimer i_timer;
+        MapUpdater m_updater;
 };
 
 template<typename Do>
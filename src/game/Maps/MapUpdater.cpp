@@ -0,0 +1,64 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Maps/MapUpdater.h"
+#include "Maps/Map.h"
+#include "Multithreading/TaskScheduler.h"
+#include "Log/Log.h"
+
+#include <algorithm>
+#include <atomic>
+
+void MapUpdater::Activate(uint32 maxParallelUpdates)
+{
+    m_maxParallelUpdates = maxParallelUpdates;
+
+    sLog.outString("MapUpdater: up to %u maps updated in parallel using %u scheduler threads", maxParallelUpdates, sTaskScheduler.GetThreadCount());
+}
+
+void MapUpdater::ScheduleUpdate(Map& map, uint32 diff)
+{
+    m_requests.push_back({ &map, diff });
+}
+
+void MapUpdater::Wait()
+{
+    if (m_requests.empty())
+        return;
+
+    // each runner picks the next not yet updated map, so one slow continent does not hold back a whole chunk of instances
+    std::atomic<size_t> nextRequest(0);
+    auto runner = [this, &nextRequest]()
+    {
+        for (size_t i = nextRequest++; i < m_requests.size(); i = nextRequest++)
+        {
+            Map::SetUpdatingMap(m_requests[i].map);
+            m_requests[i].map->Update(m_requests[i].diff);
+            Map::SetUpdatingMap(nullptr);
+        }
+    };
+
+    MaNGOS::TaskGroup group(sTaskScheduler);
+    size_t const numRunners = std::min<size_t>(m_maxParallelUpdates, m_requests.size());
+    for (size_t i = 0; i < numRunners; ++i)
+        group.Run(runner);
+
+    group.Wait();
+
+    m_requests.clear();
+}
@@ -0,0 +1,61 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_MAPUPDATER_H
+#define MANGOS_MAPUPDATER_H
+
+#include "Common.h"
+
+#include <vector>
+
+class Map;
+
+/**
+ * Updates independent maps at the same time on the shared task scheduler (sTaskScheduler).
+ *
+ * While the updates run a map may only touch its own objects. Anything that affects another map
+ * has to be queued with Map::AddMessage, messages are executed by the world thread once every
+ * scheduled update finished (see MapManager::Update).
+ */
+class MapUpdater
+{
+    public:
+        MapUpdater() : m_maxParallelUpdates(0) {}
+
+        MapUpdater(const MapUpdater&) = delete;
+        MapUpdater& operator=(const MapUpdater&) = delete;
+
+        void Activate(uint32 maxParallelUpdates);
+        void Deactivate() { m_maxParallelUpdates = 0; }
+        bool IsActive() const { return m_maxParallelUpdates != 0; }
+
+        void ScheduleUpdate(Map& map, uint32 diff);
+        void Wait();                                        // run all scheduled updates and block until they are done
+
+    private:
+        struct MapUpdateRequest
+        {
+            Map* map;
+            uint32 diff;
+        };
+
+        uint32 m_maxParallelUpdates;
+        std::vector<MapUpdateRequest> m_requests;
+};
+
+#endif
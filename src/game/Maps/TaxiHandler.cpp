@@ -115,6 +115,7 @@ void WorldSession::SendDoFlight(uint32 mountDisplayId, uint32 path, uint32 pathN
         GetPlayer()->Mount(mountDisplayId);
 
     GetPlayer()->GetMotionMaster()->MoveTaxiFlight(path, pathNode);
+    GetPlayer()->GetMap()->PrefetchTaxiPathGrids(path, pathNode);
 }
 
 bool WorldSession::SendLearnNewTaxiNode(Creature* unit)
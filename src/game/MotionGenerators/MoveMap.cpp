@@ -31,6 +31,67 @@ namespace MMAP
     // stores list of mapids which do not use pathfinding
     std::set<uint32>* g_mmapDisabledIds = nullptr;
 
+    // enough for the paths of the busy places of a map
+    static size_t const PATH_CACHE_SIZE = 256;
+
+    bool PathCache::Find(PathCacheKey const& key, dtPolyRef* path, uint32& pathLength)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        auto itr = m_pathIndex.find(key);
+        if (itr == m_pathIndex.end())
+        {
+            ++m_misses;
+            return false;
+        }
+
+        ++m_hits;
+        m_paths.splice(m_paths.begin(), m_paths, itr->second);
+
+        std::vector<dtPolyRef> const& cachedPath = itr->second->second;
+        memcpy(path, cachedPath.data(), cachedPath.size() * sizeof(dtPolyRef));
+        pathLength = cachedPath.size();
+        return true;
+    }
+
+    void PathCache::Add(PathCacheKey const& key, dtPolyRef const* path, uint32 pathLength)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        // found by another thread meantime
+        if (m_pathIndex.find(key) != m_pathIndex.end())
+            return;
+
+        if (m_paths.size() >= PATH_CACHE_SIZE)
+        {
+            m_pathIndex.erase(m_paths.back().first);
+            m_paths.pop_back();
+        }
+
+        m_paths.emplace_front(key, std::vector<dtPolyRef>(path, path + pathLength));
+        m_pathIndex.emplace(key, m_paths.begin());
+    }
+
+    void PathCache::Clear()
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_pathIndex.clear();
+        m_paths.clear();
+    }
+
+    PathStats PathCache::GetStats() const
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        PathStats stats;
+        stats.cacheSize = m_paths.size();
+        stats.cacheHits = m_hits;
+        stats.cacheMisses = m_misses;
+        stats.corridorReuses = m_corridorReuses;
+        stats.corridorRepairs = m_corridorRepairs;
+        return stats;
+    }
+
     MMapManager* MMapFactory::createOrGetMMapManager()
     {
         if (g_MMapManager == nullptr)
@@ -174,6 +235,7 @@ namespace MMAP
         MMapData* mmap_data = new MMapData(mesh);
         mmap_data->mmapLoadedTiles.clear();
 
+        std::unique_lock<std::shared_mutex> lock(m_navMeshLock);
         loadedMMaps.insert(std::pair<uint32, MMapData*>(mapId, mmap_data));
         return true;
     }
@@ -206,8 +268,11 @@ namespace MMAP
         char* fileName = new char[pathLen];
         snprintf(fileName, pathLen, (sWorld.GetDataPath() + "mmaps/%03i%02i%02i.mmtile").c_str(), mapId, x, y);
 
-        FILE* file = fopen(fileName, "rb");
-        if (!file)
+        // the tile is used in place when possible, detour writes the links and the first link of every
+        // poly into the data so those pages become private copies, vertices, detail meshes and the
+        // BV tree stay shared by the page cache with other processes
+        std::unique_ptr<MappedFile> file(new MappedFile());
+        if (!file->Open(fileName, true))
         {
             DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "ERROR: MMAP:loadMap: Could not open mmtile file '%s'", fileName);
             delete[] fileName;
@@ -216,50 +281,60 @@ namespace MMAP
         delete[] fileName;
 
         // read header
-        MmapTileHeader fileHeader;
-        fread(&fileHeader, sizeof(MmapTileHeader), 1, file);
+        MmapTileHeader const* fileHeader = file->GetAt<MmapTileHeader>(0);
 
-        if (fileHeader.mmapMagic != MMAP_MAGIC)
+        if (!fileHeader || fileHeader->mmapMagic != MMAP_MAGIC)
         {
             sLog.outError("MMAP:loadMap: Bad header in mmap %03u%02i%02i.mmtile", mapId, x, y);
-            fclose(file);
             return false;
         }
 
-        if (fileHeader.mmapVersion != MMAP_VERSION)
+        if (fileHeader->mmapVersion != MMAP_VERSION)
         {
             sLog.outError("MMAP:loadMap: %03u%02i%02i.mmtile was built with generator v%i, expected v%i",
-                          mapId, x, y, fileHeader.mmapVersion, MMAP_VERSION);
-            fclose(file);
+                          mapId, x, y, fileHeader->mmapVersion, MMAP_VERSION);
             return false;
         }
 
-        unsigned char* data = (unsigned char*)dtAlloc(fileHeader.size, DT_ALLOC_PERM);
-        MANGOS_ASSERT(data);
-
-        size_t result = fread(data, fileHeader.size, 1, file);
-        if (!result)
+        unsigned char* data = file->GetAt<unsigned char>(sizeof(MmapTileHeader), fileHeader->size);
+        if (!data)
         {
             sLog.outError("MMAP:loadMap: Bad header or data in mmap %03u%02i%02i.mmtile", mapId, x, y);
-            fclose(file);
             return false;
         }
 
-        fclose(file);
+        // detour links hold 64 bit poly refs, the data follows the 20 byte file header so it is usually
+        // not aligned for them: copy it into detour memory then, as done before the files were mapped
+        int tileFlags = 0;
+        if (reinterpret_cast<uintptr_t>(data) % 8 != 0)
+        {
+            unsigned char* copy = (unsigned char*)dtAlloc(fileHeader->size, DT_ALLOC_PERM);
+            MANGOS_ASSERT(copy);
+            memcpy(copy, data, fileHeader->size);
+
+            data = copy;
+            tileFlags = DT_TILE_FREE_DATA;
+        }
 
         dtMeshHeader* header = (dtMeshHeader*)data;
         dtTileRef tileRef = 0;
 
-        // memory allocated for data is now managed by detour, and will be deallocated when the tile is removed
-        dtStatus dtResult = mmap->navMesh->addTile(data, fileHeader.size, DT_TILE_FREE_DATA, 0, &tileRef);
+        std::unique_lock<std::shared_mutex> lock(m_navMeshLock);
+
+        // a copy is managed by detour and deallocated when the tile is removed, mapped data is owned by the file
+        dtStatus dtResult = mmap->navMesh->addTile(data, fileHeader->size, tileFlags, 0, &tileRef);
         if (dtStatusFailed(dtResult))
         {
             sLog.outError("MMAP:loadMap: Could not load %03u%02i%02i.mmtile into navmesh", mapId, x, y);
-            dtFree(data);
+            if (tileFlags & DT_TILE_FREE_DATA)
+                dtFree(data);
             return false;
         }
 
         mmap->mmapLoadedTiles.insert(std::pair<uint32, dtTileRef>(packedGridPos, tileRef));
+        if (!(tileFlags & DT_TILE_FREE_DATA))
+            mmap->mmapTileFiles[packedGridPos] = std::move(file);
+        mmap->pathCache.Clear();
         ++loadedTiles;
         DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:loadMap: Loaded mmtile %03i[%02i,%02i] into %03i[%02i,%02i]", mapId, x, y, mapId, header->x, header->y);
         return true;
@@ -288,6 +363,8 @@ namespace MMAP
 
         dtTileRef tileRef = mmap->mmapLoadedTiles[packedGridPos];
 
+        std::unique_lock<std::shared_mutex> lock(m_navMeshLock);
+
         // unload, and mark as non loaded
         dtStatus dtResult = mmap->navMesh->removeTile(tileRef, nullptr, nullptr);
         if (dtStatusFailed(dtResult))
@@ -301,6 +378,8 @@ namespace MMAP
         else
         {
             mmap->mmapLoadedTiles.erase(packedGridPos);
+            mmap->mmapTileFiles.erase(packedGridPos);
+            mmap->pathCache.Clear();
             --loadedTiles;
             DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMap: Unloaded mmtile %03i[%02i,%02i] from %03i", mapId, x, y, mapId);
             return true;
@@ -318,6 +397,8 @@ namespace MMAP
             return false;
         }
 
+        std::unique_lock<std::shared_mutex> lock(m_navMeshLock);
+
         // unload all tiles from given map
         MMapData* mmap = loadedMMaps[mapId];
         for (MMapTileSet::iterator i = mmap->mmapLoadedTiles.begin(); i != mmap->mmapLoadedTiles.end(); ++i)
@@ -400,4 +481,39 @@ namespace MMAP
 
         return mmap->navMeshQueries[instanceId];
     }
+
+    PathCache* MMapManager::GetPathCache(uint32 mapId)
+    {
+        MMapDataSet::const_iterator itr = loadedMMaps.find(mapId);
+        if (itr == loadedMMaps.end())
+            return nullptr;
+
+        return &itr->second->pathCache;
+    }
+
+    dtNavMeshQuery const* MMapManager::GetThreadNavMeshQuery(uint32 mapId)
+    {
+        MMapDataSet::const_iterator itr = loadedMMaps.find(mapId);
+        if (itr == loadedMMaps.end())
+            return nullptr;
+
+        MMapData* mmap = itr->second;
+        std::lock_guard<std::mutex> guard(mmap->threadNavMeshQueriesLock);
+
+        ThreadNavMeshQuerySet::const_iterator queryItr = mmap->threadNavMeshQueries.find(std::this_thread::get_id());
+        if (queryItr != mmap->threadNavMeshQueries.end())
+            return queryItr->second;
+
+        dtNavMeshQuery* query = dtAllocNavMeshQuery();
+        MANGOS_ASSERT(query);
+        if (dtStatusFailed(query->init(mmap->navMesh, 1024)))
+        {
+            dtFreeNavMeshQuery(query);
+            sLog.outError("MMAP:GetThreadNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId %03u", mapId);
+            return nullptr;
+        }
+
+        mmap->threadNavMeshQueries.insert(std::pair<std::thread::id, dtNavMeshQuery*>(std::this_thread::get_id(), query));
+        return query;
+    }
 }
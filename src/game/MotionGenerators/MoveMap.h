@@ -20,10 +20,16 @@
 #define _MOVE_MAP_H
 
 #include "Common.h"
+#include "Util/MappedFile.h"
 #include <Detour/Include/DetourAlloc.h>
 #include <Detour/Include/DetourNavMesh.h>
 #include <Detour/Include/DetourNavMeshQuery.h>
+#include <atomic>
+#include <list>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
+#include <thread>
 
 class Unit;
 
@@ -43,6 +49,72 @@ namespace MMAP
 {
     typedef std::unordered_map<uint32, dtTileRef> MMapTileSet;
     typedef std::unordered_map<uint32, dtNavMeshQuery*> NavMeshQuerySet;
+    typedef std::unordered_map<std::thread::id, dtNavMeshQuery*> ThreadNavMeshQuerySet;
+    typedef std::unordered_map<uint32, std::unique_ptr<MappedFile>> MMapTileFileSet;
+
+    struct PathCacheKey
+    {
+        PathCacheKey(dtPolyRef start, dtPolyRef end, uint16 include, uint16 exclude) :
+            startPoly(start), endPoly(end), includeFlags(include), excludeFlags(exclude) {}
+
+        bool operator==(PathCacheKey const& other) const
+        {
+            return startPoly == other.startPoly && endPoly == other.endPoly &&
+                includeFlags == other.includeFlags && excludeFlags == other.excludeFlags;
+        }
+
+        dtPolyRef startPoly;
+        dtPolyRef endPoly;
+        uint16 includeFlags;                // of the filter, units moving differently get different paths
+        uint16 excludeFlags;
+    };
+
+    struct PathCacheKeyHash
+    {
+        size_t operator()(PathCacheKey const& key) const
+        {
+            return std::hash<uint64>()((uint64(key.startPoly) * 0x9E3779B97F4A7C15ULL) ^ key.endPoly ^ (uint64(key.includeFlags) << 48) ^ (uint64(key.excludeFlags) << 32));
+        }
+    };
+
+    struct PathStats
+    {
+        PathStats() : cacheSize(0), cacheHits(0), cacheMisses(0), corridorReuses(0), corridorRepairs(0) {}
+
+        uint32 cacheSize;
+        uint64 cacheHits;
+        uint64 cacheMisses;
+        uint64 corridorReuses;              // previous path of the unit cut or extended instead of searched again
+        uint64 corridorRepairs;             // unit left its previous path and was walked back to it
+    };
+
+    // least recently used polygon paths between two polygons, many units chasing the same target search the same path
+    // used by the map threads and the pathfinding threads
+    class PathCache
+    {
+        public:
+            PathCache() : m_hits(0), m_misses(0), m_corridorReuses(0), m_corridorRepairs(0) {}
+
+            bool Find(PathCacheKey const& key, dtPolyRef* path, uint32& pathLength);
+            void Add(PathCacheKey const& key, dtPolyRef const* path, uint32 pathLength);
+            // polygon references of reloaded tiles change
+            void Clear();
+
+            void CountCorridorReuse() { ++m_corridorReuses; }
+            void CountCorridorRepair() { ++m_corridorRepairs; }
+            PathStats GetStats() const;
+
+        private:
+            typedef std::list<std::pair<PathCacheKey, std::vector<dtPolyRef>>> PathList;
+
+            mutable std::mutex m_lock;
+            PathList m_paths;               // most recently used first
+            std::unordered_map<PathCacheKey, PathList::iterator, PathCacheKeyHash> m_pathIndex;
+            uint64 m_hits;
+            uint64 m_misses;
+            std::atomic<uint64> m_corridorReuses;
+            std::atomic<uint64> m_corridorRepairs;
+    };
 
     // dummy struct to hold map's mmap data
     struct MMapData
@@ -53,6 +125,9 @@ namespace MMAP
             for (NavMeshQuerySet::iterator i = navMeshQueries.begin(); i != navMeshQueries.end(); ++i)
                 dtFreeNavMeshQuery(i->second);
 
+            for (ThreadNavMeshQuerySet::iterator i = threadNavMeshQueries.begin(); i != threadNavMeshQueries.end(); ++i)
+                dtFreeNavMeshQuery(i->second);
+
             if (navMesh)
                 dtFreeNavMesh(navMesh);
         }
@@ -61,7 +136,11 @@ namespace MMAP
 
         // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
         NavMeshQuerySet navMeshQueries;     // instanceId to query
+        ThreadNavMeshQuerySet threadNavMeshQueries; // pathfinding thread to query
+        std::mutex threadNavMeshQueriesLock;
+        PathCache pathCache;
         MMapTileSet mmapLoadedTiles;        // maps [map grid coords] to [dtTile]
+        MMapTileFileSet mmapTileFiles;      // maps [map grid coords] to the mapped file holding the tile data
     };
 
     typedef std::unordered_map<uint32, MMapData*> MMapDataSet;
@@ -83,6 +162,12 @@ namespace MMAP
             dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId, uint32 instanceId);
             dtNavMesh const* GetNavMesh(uint32 mapId);
 
+            // pathfinding threads hold this shared while they use a navmesh, maps and tiles are loaded and unloaded under it exclusively
+            std::shared_mutex& GetNavMeshLock() { return m_navMeshLock; }
+            // query of the calling pathfinding thread, GetNavMeshLock() must be held
+            dtNavMeshQuery const* GetThreadNavMeshQuery(uint32 mapId);
+            PathCache* GetPathCache(uint32 mapId);
+
             uint32 getLoadedTilesCount() const { return loadedTiles; }
             uint32 getLoadedMapsCount() const { return loadedMMaps.size(); }
         private:
@@ -91,6 +176,7 @@ namespace MMAP
 
             MMapDataSet loadedMMaps;
             uint32 loadedTiles;
+            std::shared_mutex m_navMeshLock;
     };
 
     // static class
@@ -22,35 +22,61 @@
 #include "MotionGenerators/PathFinder.h"
 #include "Log/Log.h"
 #include "World/World.h"
+#include "Multithreading/TaskScheduler.h"
 
 #include <Detour/Include/DetourCommon.h>
 #include <Detour/Include/DetourMath.h>
 
+struct PathFinder::AsyncRequest
+{
+    AsyncRequest(PathFinder const& path) : path(path), done(false) {}
+
+    PathFinder path;
+    std::atomic<bool> done;
+};
+
+static MaNGOS::TaskScheduler s_pathWorkers;
+
 ////////////////// PathFinder //////////////////
 PathFinder::PathFinder(Unit const* owner) :
     m_polyLength(0), m_type(PATHFIND_BLANK),
     m_useStraightPath(false), m_forceDestination(false), m_pointPathLimit(MAX_POINT_PATH_LENGTH),
-    m_sourceUnit(owner), m_navMesh(nullptr), m_navMeshQuery(nullptr)
+    m_sourceUnit(owner), m_sourceGuidLow(owner->GetGUIDLow()), m_mapId(owner->GetMapId()),
+    m_sourceIsCreature(owner->GetTypeId() == TYPEID_UNIT), m_sourceCanSwim(false), m_sourceCanFly(false),
+    m_startUnderwater(false), m_endUnderwater(false),
+    m_navMesh(nullptr), m_navMeshQuery(nullptr), m_pathCache(nullptr)
 {
-    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::PathInfo for %u \n", m_sourceUnit->GetGUIDLow());
+    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::PathInfo for %u \n", m_sourceGuidLow);
 
-    uint32 mapId = m_sourceUnit->GetMapId();
-    if (MMAP::MMapFactory::IsPathfindingEnabled(mapId, owner))
+    if (MMAP::MMapFactory::IsPathfindingEnabled(m_mapId, owner))
     {
         MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
-        m_navMesh = mmap->GetNavMesh(mapId);
-        m_navMeshQuery = mmap->GetNavMeshQuery(mapId, m_sourceUnit->GetInstanceId());
+        m_navMesh = mmap->GetNavMesh(m_mapId);
+        m_navMeshQuery = mmap->GetNavMeshQuery(m_mapId, m_sourceUnit->GetInstanceId());
+        m_pathCache = mmap->GetPathCache(m_mapId);
     }
 
     createFilter();
 }
 
+PathFinder::PathFinder(PathFinder const& other) :
+    m_polyLength(other.m_polyLength), m_pathPoints(other.m_pathPoints), m_type(other.m_type),
+    m_useStraightPath(other.m_useStraightPath), m_forceDestination(other.m_forceDestination), m_pointPathLimit(other.m_pointPathLimit),
+    m_startPosition(other.m_startPosition), m_endPosition(other.m_endPosition), m_actualEndPosition(other.m_actualEndPosition),
+    m_sourceUnit(nullptr), m_sourceGuidLow(other.m_sourceGuidLow), m_mapId(other.m_mapId),
+    m_sourceIsCreature(other.m_sourceIsCreature), m_sourceCanSwim(other.m_sourceCanSwim), m_sourceCanFly(other.m_sourceCanFly),
+    m_startUnderwater(false), m_endUnderwater(false),
+    m_navMesh(nullptr), m_navMeshQuery(nullptr), m_pathCache(nullptr), m_filter(other.m_filter)
+{
+    memcpy(m_pathPolyRefs, other.m_pathPolyRefs, m_polyLength * sizeof(dtPolyRef));
+}
+
 PathFinder::~PathFinder()
 {
-    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::~PathInfo() for %u \n", m_sourceUnit->GetGUIDLow());
+    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::~PathInfo() for %u \n", m_sourceGuidLow);
 }
 
-bool PathFinder::calculate(float destX, float destY, float destZ, bool forceDest)
+bool PathFinder::setPositions(float destX, float destY, float destZ, bool forceDest)
 {
     if (!MaNGOS::IsValidMapCoord(destX, destY, destZ))
         return false;
@@ -69,12 +95,31 @@ bool PathFinder::calculate(float destX, float destY, float destZ, bool forceDest
 
     m_forceDestination = forceDest;
 
-    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::calculate() for %u \n", m_sourceUnit->GetGUIDLow());
+    if (m_sourceIsCreature)
+    {
+        m_sourceCanSwim = ((Creature*)m_sourceUnit)->CanSwim();
+        m_sourceCanFly = ((Creature*)m_sourceUnit)->CanFly();
+    }
 
+    return true;
+}
+
+bool PathFinder::canUseNavMesh() const
+{
     // make sure navMesh works - we can run on map w/o mmap
     // check if the start and end point have a .mmtile loaded (can we pass via not loaded tile on the way?)
-    if (!m_navMesh || !m_navMeshQuery || m_sourceUnit->hasUnitState(UNIT_STAT_IGNORE_PATHFINDING) ||
-        !HaveTile(start) || !HaveTile(dest))
+    return m_navMesh && m_navMeshQuery && !m_sourceUnit->hasUnitState(UNIT_STAT_IGNORE_PATHFINDING) &&
+        HaveTile(getStartPosition()) && HaveTile(getEndPosition());
+}
+
+bool PathFinder::calculate(float destX, float destY, float destZ, bool forceDest)
+{
+    if (!setPositions(destX, destY, destZ, forceDest))
+        return false;
+
+    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::calculate() for %u \n", m_sourceGuidLow);
+
+    if (!canUseNavMesh())
     {
         BuildShortcut();
         m_type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
@@ -83,10 +128,105 @@ bool PathFinder::calculate(float destX, float destY, float destZ, bool forceDest
 
     updateFilter();
 
-    BuildPolyPath(start, dest);
+    BuildPolyPath(getStartPosition(), getEndPosition());
     return true;
 }
 
+bool PathFinder::calculateAsync(float destX, float destY, float destZ, bool forceDest)
+{
+    // the result of an older destination is not wanted anymore
+    m_asyncRequest = nullptr;
+
+    if (!s_pathWorkers.IsRunning())
+    {
+        calculate(destX, destY, destZ, forceDest);
+        return true;
+    }
+
+    if (!setPositions(destX, destY, destZ, forceDest))
+        return true;
+
+    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::calculateAsync() for %u \n", m_sourceGuidLow);
+
+    if (!canUseNavMesh())
+    {
+        BuildShortcut();
+        m_type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
+        return true;
+    }
+
+    updateFilter();
+
+    std::shared_ptr<AsyncRequest> request = std::make_shared<AsyncRequest>(*this);
+    request->path.m_startUnderwater = m_sourceUnit->GetTerrain()->IsUnderwater(m_startPosition.x, m_startPosition.y, m_startPosition.z);
+    request->path.m_endUnderwater = m_sourceUnit->GetTerrain()->IsUnderwater(m_endPosition.x, m_endPosition.y, m_endPosition.z);
+    m_asyncRequest = request;
+
+    s_pathWorkers.Submit([request]()
+    {
+        request->path.BuildPolyPathAsync();
+        request->done.store(true, std::memory_order_release);
+    });
+    return false;
+}
+
+bool PathFinder::takeAsyncResult()
+{
+    if (!m_asyncRequest || !m_asyncRequest->done.load(std::memory_order_acquire))
+        return false;
+
+    PathFinder const& result = m_asyncRequest->path;
+    m_polyLength = result.m_polyLength;
+    memcpy(m_pathPolyRefs, result.m_pathPolyRefs, m_polyLength * sizeof(dtPolyRef));
+    m_pathPoints = result.m_pathPoints;
+    m_type = result.m_type;
+    m_actualEndPosition = result.m_actualEndPosition;
+    m_asyncRequest = nullptr;
+
+    // height checks need the map of the owner, they were left to us
+    NormalizePath();
+    return true;
+}
+
+void PathFinder::BuildPolyPathAsync()
+{
+    MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
+
+    // tiles can't be unloaded while we use them
+    std::shared_lock<std::shared_mutex> lock(mmap->GetNavMeshLock());
+
+    m_navMesh = mmap->GetNavMesh(m_mapId);
+    m_navMeshQuery = mmap->GetThreadNavMeshQuery(m_mapId);
+    m_pathCache = mmap->GetPathCache(m_mapId);
+
+    // unloaded meantime
+    if (!m_navMesh || !m_navMeshQuery || !HaveTile(getStartPosition()) || !HaveTile(getEndPosition()))
+    {
+        BuildShortcut();
+        m_type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
+    }
+    else
+        BuildPolyPath(getStartPosition(), getEndPosition());
+
+    m_navMesh = nullptr;
+    m_navMeshQuery = nullptr;
+    m_pathCache = nullptr;
+}
+
+void PathFinder::StartWorkers(uint32 threads)
+{
+    if (!threads)
+        return;
+
+    s_pathWorkers.Start(threads);
+    sLog.outString("Pathfinding: using %u threads", threads);
+}
+
+void PathFinder::StopWorkers()
+{
+    s_pathWorkers.Stop();
+}
+
 dtPolyRef PathFinder::getPathPolyByPosition(const dtPolyRef* polyPath, uint32 polyPathSize, const float* point, float* distance) const
 {
     if (!polyPath || !polyPathSize)
@@ -175,14 +315,14 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: (startPoly == 0 || endPoly == 0)\n");
         BuildShortcut();
 
-        if (m_sourceUnit->GetTypeId() == TYPEID_UNIT)
+        if (m_sourceIsCreature)
         {
             // Check for swimming or flying shortcut
-            if ((startPoly == INVALID_POLYREF && m_sourceUnit->GetTerrain()->IsUnderwater(startPos.x, startPos.y, startPos.z)) ||
-                (endPoly == INVALID_POLYREF && m_sourceUnit->GetTerrain()->IsUnderwater(endPos.x, endPos.y, endPos.z)))
-                m_type = ((Creature*)m_sourceUnit)->CanSwim() ? PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH) : PATHFIND_NOPATH;
+            if ((startPoly == INVALID_POLYREF && IsUnderwater(startPos)) ||
+                (endPoly == INVALID_POLYREF && IsUnderwater(endPos)))
+                m_type = m_sourceCanSwim ? PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH) : PATHFIND_NOPATH;
             else
-                m_type = ((Creature*)m_sourceUnit)->CanFly() ? PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH) : PATHFIND_NOPATH;
+                m_type = m_sourceCanFly ? PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH) : PATHFIND_NOPATH;
         }
         else
             m_type = PATHFIND_NOPATH;
@@ -197,21 +337,19 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: farFromPoly distToStartPoly=%.3f distToEndPoly=%.3f\n", distToStartPoly, distToEndPoly);
 
         bool buildShotrcut = false;
-        if (m_sourceUnit->GetTypeId() == TYPEID_UNIT)
+        if (m_sourceIsCreature)
         {
-            Creature* owner = (Creature*)m_sourceUnit;
-
             Vector3 p = (distToStartPoly > 7.0f) ? startPos : endPos;
-            if (m_sourceUnit->GetTerrain()->IsUnderwater(p.x, p.y, p.z))
+            if (IsUnderwater(p))
             {
                 DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: underWater case\n");
-                if (owner->CanSwim())
+                if (m_sourceCanSwim)
                     buildShotrcut = true;
             }
             else
             {
                 DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: flying case\n");
-                if (owner->CanFly())
+                if (m_sourceCanFly)
                     buildShotrcut = true;
             }
         }
@@ -270,7 +408,7 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
                 sLog.outError("Invalid poly ref in BuildPolyPath. polyLength: %u, pathStartIndex: %u,"
                     " startPos: %s, endPos: %s, mapId: %u",
                     m_polyLength, pathStartIndex, startPos.toString().c_str(), endPos.toString().c_str(),
-                    m_sourceUnit->GetMapId());
+                    m_mapId);
                 break;
             }
 
@@ -281,6 +419,13 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
             }
         }
 
+        // we left the path, it can still be used if we are only a few polygons away from its start
+        if (!startPolyFound && RepairCorridorStart(startPoly, startPoint))
+        {
+            startPolyFound = true;
+            pathStartIndex = 0;
+        }
+
         for (pathEndIndex = m_polyLength - 1; pathEndIndex > pathStartIndex; --pathEndIndex)
         {
             if (m_pathPolyRefs[pathEndIndex] == endPoly)
@@ -301,6 +446,9 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
 
         m_polyLength = pathEndIndex - pathStartIndex + 1;
         memmove(m_pathPolyRefs, m_pathPolyRefs + pathStartIndex, m_polyLength * sizeof(dtPolyRef));
+
+        if (m_pathCache)
+            m_pathCache->CountCorridorReuse();
     }
     else if (startPolyFound && !endPolyFound)
     {
@@ -357,13 +505,16 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
             // this is probably an error state, but we'll leave it
             // and hopefully recover on the next Update
             // we still need to copy our preffix
-            sLog.outError("%u's Path Build failed: 0 length path", m_sourceUnit->GetGUIDLow());
+            sLog.outError("%u's Path Build failed: 0 length path", m_sourceGuidLow);
         }
 
         DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++  m_polyLength=%u prefixPolyLength=%u suffixPolyLength=%u \n", m_polyLength, prefixPolyLength, suffixPolyLength);
 
         // new path = prefix + suffix - overlap
         m_polyLength = prefixPolyLength + suffixPolyLength - 1;
+
+        if (m_pathCache)
+            m_pathCache->CountCorridorReuse();
     }
     else
     {
@@ -376,23 +527,32 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         // free and invalidate old path data
         clear();
 
-        dtResult = m_navMeshQuery->findPath(
-                       startPoly,          // start polygon
-                       endPoly,            // end polygon
-                       startPoint,         // start position
-                       endPoint,           // end position
-                       &m_filter,           // polygon search filter
-                       m_pathPolyRefs,     // [out] path
-                       (int*)&m_polyLength,
-                       MAX_PATH_LENGTH);   // max number of polygons in output path
-
-        if (!m_polyLength || dtStatusFailed(dtResult))
+        // other units may have gone the same way recently
+        MMAP::PathCacheKey const cacheKey(startPoly, endPoly, m_filter.getIncludeFlags(), m_filter.getExcludeFlags());
+        if (!m_pathCache || !m_pathCache->Find(cacheKey, m_pathPolyRefs, m_polyLength))
         {
-            // only happens if we passed bad data to findPath(), or navmesh is messed up
-            sLog.outError("%u's Path Build failed: 0 length path", m_sourceUnit->GetGUIDLow());
-            BuildShortcut();
-            m_type = PATHFIND_NOPATH;
-            return;
+            dtResult = m_navMeshQuery->findPath(
+                           startPoly,          // start polygon
+                           endPoly,            // end polygon
+                           startPoint,         // start position
+                           endPoint,           // end position
+                           &m_filter,           // polygon search filter
+                           m_pathPolyRefs,     // [out] path
+                           (int*)&m_polyLength,
+                           MAX_PATH_LENGTH);   // max number of polygons in output path
+
+            if (!m_polyLength || dtStatusFailed(dtResult))
+            {
+                // only happens if we passed bad data to findPath(), or navmesh is messed up
+                sLog.outError("%u's Path Build failed: 0 length path", m_sourceGuidLow);
+                BuildShortcut();
+                m_type = PATHFIND_NOPATH;
+                return;
+            }
+
+            // partial paths depend on where the search gave up, they are not shared
+            if (m_pathCache && m_pathPolyRefs[m_polyLength - 1] == endPoly)
+                m_pathCache->Add(cacheKey, m_pathPolyRefs, m_polyLength);
         }
     }
 
@@ -406,6 +566,35 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
     BuildPointPath(startPoint, endPoint);
 }
 
+bool PathFinder::RepairCorridorStart(dtPolyRef startPoly, const float* startPoint)
+{
+    // same as dtPathCorridor::movePosition, walk from the start of the path to our position
+    float corridorStart[VERTEX_SIZE];
+    if (dtStatusFailed(m_navMeshQuery->closestPointOnPoly(m_pathPolyRefs[0], startPoint, corridorStart, nullptr)))
+        return false;
+
+    float result[VERTEX_SIZE];
+    dtPolyRef visited[MAX_CORRIDOR_REPAIR_POLYS];
+    int visitedCount = 0;
+    dtStatus dtResult = m_navMeshQuery->moveAlongSurface(m_pathPolyRefs[0], corridorStart, startPoint, &m_filter,
+                        result, visited, &visitedCount, MAX_CORRIDOR_REPAIR_POLYS);
+
+    // too far or blocked
+    if (dtStatusFailed(dtResult) || !visitedCount || visited[visitedCount - 1] != startPoly)
+        return false;
+
+    // the walked polygons replace the start of the path
+    m_polyLength = fixupCorridor(m_pathPolyRefs, m_polyLength, MAX_PATH_LENGTH, visited, visitedCount);
+    if (m_pathPolyRefs[0] != startPoly)
+        return false;
+
+    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ RepairCorridorStart :: walked %d polygons back to the path\n", visitedCount);
+
+    if (m_pathCache)
+        m_pathCache->CountCorridorRepair();
+    return true;
+}
+
 void PathFinder::BuildPointPath(const float* startPoint, const float* endPoint)
 {
     float pathPoints[MAX_POINT_PATH_LENGTH * VERTEX_SIZE];
@@ -456,8 +645,8 @@ void PathFinder::BuildPointPath(const float* startPoint, const float* endPoint)
         return;
     }
 
-    // Normalize calculated path points first
-    if (sWorld.getConfig(CONFIG_BOOL_PATH_FIND_NORMALIZE_Z))
+    // Normalize calculated path points first, the pathfinding threads leave it to takeAsyncResult()
+    if (sWorld.getConfig(CONFIG_BOOL_PATH_FIND_NORMALIZE_Z) && m_sourceUnit)
     {
         for (uint32 i = 0; i < pointCount; ++i)
         {
@@ -559,7 +748,7 @@ void PathFinder::BuildPointPath(const float* startPoint, const float* endPoint)
 
 void PathFinder::NormalizePath()
 {
-    if (!sWorld.getConfig(CONFIG_BOOL_PATH_FIND_NORMALIZE_Z))
+    if (!sWorld.getConfig(CONFIG_BOOL_PATH_FIND_NORMALIZE_Z) || !m_sourceUnit)
         return;
 
     for (uint32 i = 0; i < m_pathPoints.size(); ++i)
@@ -645,6 +834,15 @@ NavTerrainFlag PathFinder::getNavTerrain(float x, float y, float z)
     }
 }
 
+bool PathFinder::IsUnderwater(const Vector3& p) const
+{
+    // the pathfinding threads only know about the start and the end, they are checked when the path is queued
+    if (!m_sourceUnit)
+        return p == getStartPosition() ? m_startUnderwater : m_endUnderwater;
+
+    return m_sourceUnit->GetTerrain()->IsUnderwater(p.x, p.y, p.z);
+}
+
 bool PathFinder::HaveTile(const Vector3& p) const
 {
     int tx = -1, ty = -1;
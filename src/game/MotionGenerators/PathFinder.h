@@ -26,11 +26,19 @@
 
 #include "Movement/MoveSplineInitArgs.h"
 
+#include <atomic>
+#include <memory>
+
 using Movement::Vector3;
 using Movement::PointsArray;
 
 class Unit;
 
+namespace MMAP
+{
+    class PathCache;
+}
+
 // 74*4.0f=296y  number_of_points*interval = max_path_len
 // this is way more than actual evade range
 // I think we can safely cut those down even more
@@ -49,6 +57,9 @@ class Unit;
 #define VERTEX_SIZE             3
 #define INVALID_POLYREF         0
 
+// polygons walked through to bring a unit which left its path back to it
+#define MAX_CORRIDOR_REPAIR_POLYS 16
+
 enum PathType
 {
     PATHFIND_BLANK          = 0x0000,   // path not built yet
@@ -70,6 +81,16 @@ class PathFinder
         // return: true if new path was calculated, false otherwise (no change needed)
         bool calculate(float destX, float destY, float destZ, bool forceDest = false);
 
+        // Same as calculate, but the navmesh part is done by the pathfinding threads, the current path is kept meanwhile
+        // return: true if the path was calculated at once, otherwise takeAsyncResult() gives it later
+        bool calculateAsync(float destX, float destY, float destZ, bool forceDest = false);
+        // return: true if the path of calculateAsync was taken, false if it is not ready or nothing was queued
+        bool takeAsyncResult();
+        bool isCalculating() const { return m_asyncRequest != nullptr; }
+
+        static void StartWorkers(uint32 threads);
+        static void StopWorkers();
+
         // option setters - use optional
         void setUseStrightPath(bool useStraightPath) { m_useStraightPath = useStraightPath; };
         void setPathLengthLimit(float distance) { m_pointPathLimit = std::min<uint32>(uint32(distance / SMOOTH_PATH_STEP_SIZE), MAX_POINT_PATH_LENGTH); };
@@ -83,6 +104,10 @@ class PathFinder
         PathType getPathType() const { return m_type; }
 
     private:
+        struct AsyncRequest;
+
+        // copy of the calculation state for the pathfinding threads, which must not use the owner
+        PathFinder(PathFinder const& other);
 
         dtPolyRef      m_pathPolyRefs[MAX_PATH_LENGTH];   // array of detour polygon references
         uint32         m_polyLength;                      // number of polygons in the path
@@ -98,9 +123,18 @@ class PathFinder
         Vector3        m_endPosition;      // {x, y, z} of the destination
         Vector3        m_actualEndPosition;// {x, y, z} of the closest possible point to given destination
 
-        const Unit* const       m_sourceUnit;       // the unit that is moving
+        const Unit* const       m_sourceUnit;       // the unit that is moving, nullptr in copies built by the pathfinding threads
+        uint32                  m_sourceGuidLow;
+        uint32                  m_mapId;
+        bool                    m_sourceIsCreature;
+        bool                    m_sourceCanSwim;    // set at each calculation
+        bool                    m_sourceCanFly;
+        bool                    m_startUnderwater;  // only set for the pathfinding threads
+        bool                    m_endUnderwater;
+        std::shared_ptr<AsyncRequest> m_asyncRequest;
         const dtNavMesh*        m_navMesh;          // the nav mesh
         const dtNavMeshQuery*   m_navMeshQuery;     // the nav mesh query used to find the path
+        MMAP::PathCache*        m_pathCache;        // paths recently found on the map
 
         dtQueryFilter m_filter;                     // use single filter for all movements, update it when needed
 
@@ -122,8 +156,14 @@ class PathFinder
         dtPolyRef getPathPolyByPosition(const dtPolyRef* polyPath, uint32 polyPathSize, const float* point, float* distance = nullptr) const;
         dtPolyRef getPolyByLocation(const float* point, float* distance) const;
         bool HaveTile(const Vector3& p) const;
+        bool IsUnderwater(const Vector3& p) const;
+
+        bool setPositions(float destX, float destY, float destZ, bool forceDest);
+        bool canUseNavMesh() const;
+        void BuildPolyPathAsync();
 
         void BuildPolyPath(const Vector3& startPos, const Vector3& endPos);
+        bool RepairCorridorStart(dtPolyRef startPoly, const float* startPoint);
         void BuildPointPath(const float* startPoint, const float* endPoint);
         void BuildShortcut();
 
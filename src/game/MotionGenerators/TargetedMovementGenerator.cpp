@@ -75,7 +75,19 @@ void TargetedMovementGeneratorMedium<T, D>::_setTargetLocation(T& owner, bool up
     // allow pets following their master to cheat while generating paths
     bool forceDest = (owner.GetTypeId() == TYPEID_UNIT && ((Creature*)&owner)->IsPet()
                       && owner.hasUnitState(UNIT_STAT_FOLLOW));
-    i_path->calculate(x, y, z, forceDest);
+
+    // the current spline is followed until the new path is calculated, nothing to follow when stopped
+    if (owner.movespline->Finalized())
+        i_path->calculate(x, y, z, forceDest);
+    else if (!i_path->calculateAsync(x, y, z, forceDest))
+        return;
+
+    _launchPath(owner);
+}
+
+template<class T, typename D>
+void TargetedMovementGeneratorMedium<T, D>::_launchPath(T& owner)
+{
     if (i_path->getPathType() & PATHFIND_NOPATH)
         return;
 
@@ -125,16 +137,24 @@ bool TargetedMovementGeneratorMedium<T, D>::Update(T& owner, const uint32& time_
         return true;
     }
 
+    // a path calculated by the pathfinding threads meanwhile is followed at once
+    if (i_path && i_path->takeAsyncResult())
+        _launchPath(owner);
+
+    // while a path is calculated the spline still leads to the old destination, compare with the requested one
+    bool calculating = i_path && i_path->isCalculating();
+
     bool targetMoved = false;
     i_recheckDistance.Update(time_diff);
     if (i_recheckDistance.Passed())
     {
         i_recheckDistance.Reset(this->GetMovementGeneratorType() == FOLLOW_MOTION_TYPE ? 50 : 100);
-        G3D::Vector3 dest = owner.movespline->FinalDestination();
+        G3D::Vector3 dest = calculating ? i_path->getEndPosition() : owner.movespline->FinalDestination();
         targetMoved = RequiresNewPosition(owner, dest.x, dest.y, dest.z);
     }
 
-    if (m_speedChanged || targetMoved)
+    // the pending path is launched with the new speed anyway
+    if (targetMoved || (m_speedChanged && !calculating))
         _setTargetLocation(owner, targetMoved);
 
     if (owner.movespline->Finalized())
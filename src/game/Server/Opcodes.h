@@ -1446,7 +1446,8 @@ enum PacketProcessing
 {
     PROCESS_INPLACE = 0,                                    // process packet whenever we receive it - mostly for non-handled or non-implemented packets
     PROCESS_THREADUNSAFE,                                   // packet is not thread-safe - process it in World::UpdateSessions()
-    PROCESS_THREADSAFE                                      // packet is thread-safe - process it in Map::Update()
+    PROCESS_THREADSAFE,                                     // packet is thread-safe - process it in Map::Update()
+    PROCESS_READONLY                                        // packet only reads shared data and answers its own session - process it on the session thread pool
 };
 
 class WorldPacket;
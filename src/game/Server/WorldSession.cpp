@@ -35,6 +35,7 @@
 #include "Guilds/Guild.h"
 #include "Guilds/GuildMgr.h"
 #include "World/World.h"
+#include "Maps/MapManager.h"
 #include "BattleGround/BattleGroundMgr.h"
 #include "Social/SocialMgr.h"
 #include "Auth/HMACSHA1.h"
@@ -64,6 +65,10 @@ static bool MapSessionFilterHelper(WorldSession* session, OpcodeHandler const& o
     if (opHandle.packetProcessing == PROCESS_THREADUNSAFE)
         return false;
 
+    // read-only packets are answered by the session thread pool or the world thread, never during map updates
+    if (opHandle.packetProcessing == PROCESS_READONLY)
+        return false;
+
     // we do not process not loggined player packets
     Player* plr = session->GetPlayer();
     if (!plr)
@@ -131,6 +136,39 @@ char const* WorldSession::GetPlayerName() const
 
 /// Send a packet to the client
 void WorldSession::SendPacket(WorldPacket const& packet) const
+{
+    if (!PrepareSendPacket(packet))
+        return;
+
+    m_Socket->SendPacket(packet);
+}
+
+void WorldSession::SendPacket(SharedWorldPacket const& packet) const
+{
+    if (!PrepareSendPacket(*packet))
+        return;
+
+    m_Socket->SendPacket(packet);
+}
+
+void SharedPacketSender::SendTo(WorldSession* session)
+{
+    // small packets are copied by the socket anyway, a single receiver needs no shared copy
+    if (!m_sent || m_packet.size() < size_t(MaNGOS::Socket::MinSharedWriteSize))
+    {
+        m_sent = true;
+        session->SendPacket(m_packet);
+        return;
+    }
+
+    if (!m_shared)
+        m_shared = std::make_shared<WorldPacket const>(m_packet);
+
+    session->SendPacket(m_shared);
+}
+
+/// Bot forwarding and statistics common to all sends, return false if the packet can't reach the client
+bool WorldSession::PrepareSendPacket(WorldPacket const& packet) const
 {
 #ifdef BUILD_DEPRECATED_PLAYERBOT
     // Send packet to bot AI
@@ -144,7 +182,7 @@ void WorldSession::SendPacket(WorldPacket const& packet) const
 #endif
 
     if (!m_Socket || m_Socket->IsClosed())
-        return;
+        return false;
 
 #ifdef MANGOS_DEBUG
 
@@ -182,7 +220,7 @@ void WorldSession::SendPacket(WorldPacket const& packet) const
 
 #endif                                                  // !MANGOS_DEBUG
 
-    m_Socket->SendPacket(packet);
+    return true;
 }
 
 /// Add an incoming packet to the queue
@@ -219,104 +257,14 @@ bool WorldSession::Update(PacketFilter& updater)
     /// not process packets if socket already closed
     while (m_Socket && !m_Socket->IsClosed() && !m_recvQueue.empty())
     {
+        // with parallel map updates, stop at the first packet this context may not handle, it is left for the other update pass
+        if (sMapMgr.IsUpdatingInParallel() && !updater.Process(m_recvQueue.front().get()))
+            break;
+
         auto const packet = std::move(m_recvQueue.front());
         m_recvQueue.pop_front();
 
-        /*#if 1
-        sLog.outError( "MOEP: %s (0x%.4X)",
-                        packet->GetOpcodeName(),
-                        packet->GetOpcode());
-        #endif*/
-
-        OpcodeHandler const& opHandle = opcodeTable[packet->GetOpcode()];
-        try
-        {
-            switch (opHandle.status)
-            {
-                case STATUS_LOGGEDIN:
-                    if (!_player)
-                    {
-                        // skip STATUS_LOGGEDIN opcode unexpected errors if player logout sometime ago - this can be network lag delayed packets
-                        if (!m_playerRecentlyLogout)
-                            LogUnexpectedOpcode(*packet, "the player has not logged in yet");
-                    }
-                    else if (_player->IsInWorld())
-                        ExecuteOpcode(opHandle, *packet);
-
-                    // lag can cause STATUS_LOGGEDIN opcodes to arrive after the player started a transfer
-
-#ifdef BUILD_DEPRECATED_PLAYERBOT
-                    if (_player && _player->GetPlayerbotMgr())
-                        _player->GetPlayerbotMgr()->HandleMasterIncomingPacket(*packet);
-#endif
-                    break;
-                case STATUS_LOGGEDIN_OR_RECENTLY_LOGGEDOUT:
-                    if (!_player && !m_playerRecentlyLogout)
-                    {
-                        LogUnexpectedOpcode(*packet, "the player has not logged in yet and not recently logout");
-                    }
-                    else
-                        // not expected _player or must checked in packet hanlder
-                        ExecuteOpcode(opHandle, *packet);
-                    break;
-                case STATUS_TRANSFER:
-                    if (!_player)
-                        LogUnexpectedOpcode(*packet, "the player has not logged in yet");
-                    else if (_player->IsInWorld())
-                        LogUnexpectedOpcode(*packet, "the player is still in world");
-                    else
-                        ExecuteOpcode(opHandle, *packet);
-                    break;
-                case STATUS_AUTHED:
-                    // prevent cheating with skip queue wait
-                    if (m_inQueue)
-                    {
-                        LogUnexpectedOpcode(*packet, "the player not pass queue yet");
-                        break;
-                    }
-
-                    // single from authed time opcodes send in to after logout time
-                    // and before other STATUS_LOGGEDIN_OR_RECENTLY_LOGGOUT opcodes.
-                    if (packet->GetOpcode() != CMSG_SET_ACTIVE_VOICE_CHANNEL)
-                        m_playerRecentlyLogout = false;
-
-                    ExecuteOpcode(opHandle, *packet);
-                    break;
-                case STATUS_NEVER:
-                    sLog.outError("SESSION: received not allowed opcode %s (0x%.4X)",
-                                  packet->GetOpcodeName(),
-                                  packet->GetOpcode());
-                    break;
-                case STATUS_UNHANDLED:
-                    DEBUG_LOG("SESSION: received not handled opcode %s (0x%.4X)",
-                              LookupOpcodeName(packet->GetOpcode()),
-                              packet->GetOpcode());
-                    break;
-                default:
-                    sLog.outError("SESSION: received wrong-status-req opcode %s (0x%.4X)",
-                                  packet->GetOpcodeName(),
-                                  packet->GetOpcode());
-                    break;
-            }
-        }
-        catch (ByteBufferException&)
-        {
-            sLog.outError("WorldSession::Update ByteBufferException occured while parsing a packet (opcode: %u) from client %s, accountid=%i.",
-                          packet->GetOpcode(), GetRemoteAddress().c_str(), GetAccountId());
-            if (sLog.HasLogLevelOrHigher(LOG_LVL_DEBUG))
-            {
-                DEBUG_LOG("Dumping error causing packet:");
-                packet->hexlike();
-            }
-
-            if (sWorld.getConfig(CONFIG_BOOL_KICK_PLAYER_ON_BAD_PACKET))
-            {
-                DETAIL_LOG("Disconnecting session [account id %u / address %s] for badly formatted packet.",
-                           GetAccountId(), GetRemoteAddress().c_str());
-
-                KickPlayer();
-            }
-        }
+        ProcessPacket(*packet);
     }
 
 #ifdef BUILD_DEPRECATED_PLAYERBOT
@@ -366,6 +314,123 @@ bool WorldSession::Update(PacketFilter& updater)
     return true;
 }
 
+/// Process the thread-safe packets waiting at the front of the receive queue (triggered by the session thread pool)
+void WorldSession::UpdateThreadSafePackets()
+{
+#ifdef BUILD_DEPRECATED_PLAYERBOT
+    // master packets are forwarded to the bots, leave everything to Update()
+    if (_player && _player->GetPlayerbotMgr())
+        return;
+#endif
+
+    std::lock_guard<std::mutex> guard(m_recvQueueLock);
+
+    // stop at the first other packet, packets of a session are always handled in the order they were received
+    while (m_Socket && !m_Socket->IsClosed() && !m_recvQueue.empty())
+    {
+        if (opcodeTable[m_recvQueue.front()->GetOpcode()].packetProcessing != PROCESS_READONLY)
+            break;
+
+        auto const packet = std::move(m_recvQueue.front());
+        m_recvQueue.pop_front();
+
+        ProcessPacket(*packet);
+    }
+}
+
+void WorldSession::ProcessPacket(WorldPacket& packet)
+{
+    OpcodeHandler const& opHandle = opcodeTable[packet.GetOpcode()];
+    try
+    {
+        switch (opHandle.status)
+        {
+            case STATUS_LOGGEDIN:
+                if (!_player)
+                {
+                    // skip STATUS_LOGGEDIN opcode unexpected errors if player logout sometime ago - this can be network lag delayed packets
+                    if (!m_playerRecentlyLogout)
+                        LogUnexpectedOpcode(packet, "the player has not logged in yet");
+                }
+                else if (_player->IsInWorld())
+                    ExecuteOpcode(opHandle, packet);
+
+                // lag can cause STATUS_LOGGEDIN opcodes to arrive after the player started a transfer
+
+#ifdef BUILD_DEPRECATED_PLAYERBOT
+                if (_player && _player->GetPlayerbotMgr())
+                    _player->GetPlayerbotMgr()->HandleMasterIncomingPacket(packet);
+#endif
+                break;
+            case STATUS_LOGGEDIN_OR_RECENTLY_LOGGEDOUT:
+                if (!_player && !m_playerRecentlyLogout)
+                {
+                    LogUnexpectedOpcode(packet, "the player has not logged in yet and not recently logout");
+                }
+                else
+                    // not expected _player or must checked in packet hanlder
+                    ExecuteOpcode(opHandle, packet);
+                break;
+            case STATUS_TRANSFER:
+                if (!_player)
+                    LogUnexpectedOpcode(packet, "the player has not logged in yet");
+                else if (_player->IsInWorld())
+                    LogUnexpectedOpcode(packet, "the player is still in world");
+                else
+                    ExecuteOpcode(opHandle, packet);
+                break;
+            case STATUS_AUTHED:
+                // prevent cheating with skip queue wait
+                if (m_inQueue)
+                {
+                    LogUnexpectedOpcode(packet, "the player not pass queue yet");
+                    break;
+                }
+
+                // single from authed time opcodes send in to after logout time
+                // and before other STATUS_LOGGEDIN_OR_RECENTLY_LOGGOUT opcodes.
+                if (packet.GetOpcode() != CMSG_SET_ACTIVE_VOICE_CHANNEL)
+                    m_playerRecentlyLogout = false;
+
+                ExecuteOpcode(opHandle, packet);
+                break;
+            case STATUS_NEVER:
+                sLog.outError("SESSION: received not allowed opcode %s (0x%.4X)",
+                              packet.GetOpcodeName(),
+                              packet.GetOpcode());
+                break;
+            case STATUS_UNHANDLED:
+                DEBUG_LOG("SESSION: received not handled opcode %s (0x%.4X)",
+                          LookupOpcodeName(packet.GetOpcode()),
+                          packet.GetOpcode());
+                break;
+            default:
+                sLog.outError("SESSION: received wrong-status-req opcode %s (0x%.4X)",
+                              packet.GetOpcodeName(),
+                              packet.GetOpcode());
+                break;
+        }
+    }
+    catch (ByteBufferException&)
+    {
+        sLog.outError("WorldSession::Update ByteBufferException occured while parsing a packet (opcode: %u) from client %s, accountid=%i.",
+                      packet.GetOpcode(), GetRemoteAddress().c_str(), GetAccountId());
+        if (sLog.HasLogLevelOrHigher(LOG_LVL_DEBUG))
+        {
+            DEBUG_LOG("Dumping error causing packet:");
+            packet.hexlike();
+        }
+
+        if (sWorld.getConfig(CONFIG_BOOL_KICK_PLAYER_ON_BAD_PACKET))
+        {
+            DETAIL_LOG("Disconnecting session [account id %u / address %s] for badly formatted packet.",
+                       GetAccountId(), GetRemoteAddress().c_str());
+
+            KickPlayer();
+        }
+    }
+}
+
 /// %Log the player out
 void WorldSession::LogoutPlayer(bool Save)
 {
@@ -1055,6 +1120,17 @@ void WorldSession::SetPlayer(Player* plr)
         m_GUIDLow = _player->GetGUIDLow();
 }
 
+/// Key used to order async character database writes, see CharacterDatabaseAsyncRouting
+uint32 WorldSession::GetCharacterSerialKey(ObjectGuid guid) const
+{
+    switch (sWorld.getConfig(CONFIG_UINT32_CHARACTER_DB_ASYNC_ROUTING))
+    {
+        case CHARACTER_DB_ROUTING_CHARACTER: return guid.GetCounter();
+        case CHARACTER_DB_ROUTING_ACCOUNT:   return GetAccountId();
+        default:                             return 0;
+    }
+}
+
 void WorldSession::SendRedirectClient(std::string& ip, uint16 port)
 {
     const uint32 ip2 = static_cast<uint32>(boost::asio::ip::make_address_v4(ip).to_uint());
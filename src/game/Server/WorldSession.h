@@ -36,6 +36,7 @@
 
 struct ItemPrototype;
 struct AuctionEntry;
+class AuctionHouseObject;
 struct AuctionHouseEntry;
 struct DeclinedName;
 struct TradeStatusInfo;
@@ -249,6 +250,7 @@ class WorldSession
         void SendAddonsInfo();
 
         void SendPacket(WorldPacket const& packet) const;
+        void SendPacket(SharedWorldPacket const& packet) const;
         void SendNotification(const char* format, ...) ATTR_PRINTF(2, 3);
         void SendNotification(int32 string_id, ...);
         void SendPetNameInvalid(uint32 error, const std::string& name, DeclinedName* declinedName);
@@ -274,7 +276,17 @@ class WorldSession
 #else
         const std::string GetRemoteAddress() const { return m_Socket->GetRemoteAddress(); }
 #endif
+        // outgoing traffic of the connection, false for sessions without one
+        bool GetOutputStats(MaNGOS::SocketOutputStats& stats) const
+        {
+            if (!m_Socket)
+                return false;
+
+            stats = m_Socket->GetOutputStats();
+            return true;
+        }
         void SetPlayer(Player* plr);
+        uint32 GetCharacterSerialKey(ObjectGuid guid) const;
         uint8 Expansion() const { return m_expansion; }
 
         /// Session in auth.queue currently
@@ -301,6 +313,7 @@ class WorldSession
         void QueuePacket(std::unique_ptr<WorldPacket> new_packet);
 
         bool Update(PacketFilter& updater);
+        void UpdateThreadSafePackets();
 
         /// Handle the authentication waiting queue (to be completed)
         void SendAuthWaitQue(uint32 position);
@@ -371,7 +384,7 @@ class WorldSession
         void SendAuctionRemovedNotification(AuctionEntry* auction);
         static void SendAuctionOutbiddedMail(AuctionEntry* auction);
         void SendAuctionCancelledToBidderMail(AuctionEntry* auction);
-        void BuildListAuctionItems(std::vector<AuctionEntry*> const& auctions, WorldPacket& data, std::wstring const& searchedname, uint32 listfrom, uint32 levelmin,
+        void BuildListAuctionItems(AuctionHouseObject const* auctionHouse, uint8* sort, WorldPacket& data, std::wstring const& searchedname, uint32 listfrom, uint32 levelmin,
                                    uint32 levelmax, uint32 usable, uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality, uint32& count, uint32& totalcount, bool isFull);
 
         AuctionHouseEntry const* GetCheckedAuctionHouseForAuctioneer(ObjectGuid guid);
@@ -897,6 +910,8 @@ class WorldSession
         bool VerifyMovementInfo(MovementInfo const& movementInfo, ObjectGuid const& guid) const;
         void HandleMoverRelocation(MovementInfo& movementInfo);
 
+        void ProcessPacket(WorldPacket& packet);
+        bool PrepareSendPacket(WorldPacket const& packet) const;
         void ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket & packet);
 
         // logging helper
@@ -929,5 +944,19 @@ class WorldSession
         std::mutex m_recvQueueLock;
         std::deque<std::unique_ptr<WorldPacket>> m_recvQueue;
 };
+
+/// Sends one packet to many sessions, from the second receiver on its body is copied once and then shared by all sockets
+class SharedPacketSender
+{
+    public:
+        explicit SharedPacketSender(WorldPacket const& packet) : m_packet(packet), m_sent(false) {}
+
+        void SendTo(WorldSession* session);
+
+    private:
+        WorldPacket const& m_packet;
+        SharedWorldPacket m_shared;
+        bool m_sent;
+};
 #endif
 /// @}
@@ -31,12 +31,15 @@
 #include "Util/CommonDefines.h"
 #include "Log/Log.h"
 #include "Server/DBCStores.h"
+#include "Entities/UpdateData.h"
+#include "Multithreading/TaskScheduler.h"
 #ifdef BUILD_ELUNA
 #include "LuaEngine/LuaEngine.h"
 #endif
 
 #include <chrono>
 #include <functional>
+#include <mutex>
 
 #include <boost/asio.hpp>
 
@@ -87,7 +90,7 @@ struct ServerPktHeader
 
 WorldSocket::WorldSocket(boost::asio::io_context &context, std::function<void (Socket *)> closeHandler)
     : Socket(context, closeHandler), m_lastPingTime(std::chrono::system_clock::time_point::min()), m_overSpeedPings(0),
-      m_useExistingHeader(false), m_session(nullptr),m_seed(urand())
+      m_useExistingHeader(false), m_session(nullptr),m_seed(urand()), m_sendQueueScheduled(false), m_authPending(false)
 {
     InitializeOpcodes();
 }
@@ -100,6 +103,89 @@ void WorldSocket::SendPacket(const WorldPacket& pct, bool immediate)
     // Dump outgoing packet.
     sLog.outWorldPacketDump(GetRemoteEndpoint().c_str(), pct.GetOpcode(), pct.GetOpcodeName(), pct, false);
 
+    std::lock_guard<std::mutex> guard(m_sendQueueLock);
+
+    if (!m_sendQueueScheduled && !UpdateData::IsCompressible(pct))
+    {
+        WritePacket(pct, immediate);
+        return;
+    }
+
+    // compression is left to the network thread, packets sent meanwhile wait behind to keep the order
+    m_sendQueue.push_back({ std::make_shared<WorldPacket const>(pct), immediate });
+
+    if (!m_sendQueueScheduled)
+    {
+        m_sendQueueScheduled = true;
+
+        std::shared_ptr<WorldSocket> ptr = shared<WorldSocket>();
+        boost::asio::post(GetAsioSocket().get_executor(), [ptr]() { ptr->ProcessSendQueue(); });
+    }
+}
+
+void WorldSocket::SendPacket(SharedWorldPacket const& pct, bool immediate)
+{
+    if (IsClosed())
+        return;
+
+    // Dump outgoing packet.
+    sLog.outWorldPacketDump(GetRemoteEndpoint().c_str(), pct->GetOpcode(), pct->GetOpcodeName(), *pct, false);
+
+    std::lock_guard<std::mutex> guard(m_sendQueueLock);
+
+    if (!m_sendQueueScheduled && !UpdateData::IsCompressible(*pct))
+    {
+        WritePacket(pct, immediate);
+        return;
+    }
+
+    m_sendQueue.push_back({ pct, immediate });
+
+    if (!m_sendQueueScheduled)
+    {
+        m_sendQueueScheduled = true;
+
+        std::shared_ptr<WorldSocket> ptr = shared<WorldSocket>();
+        boost::asio::post(GetAsioSocket().get_executor(), [ptr]() { ptr->ProcessSendQueue(); });
+    }
+}
+
+void WorldSocket::ProcessSendQueue()
+{
+    std::unique_lock<std::mutex> guard(m_sendQueueLock);
+
+    while (!m_sendQueue.empty())
+    {
+        std::deque<QueuedPacket> queue;
+        queue.swap(m_sendQueue);
+
+        // compress without blocking the threads sending new packets
+        guard.unlock();
+
+        for (auto& queued : queue)
+        {
+            if (!UpdateData::IsCompressible(*queued.packet))
+                continue;
+
+            std::shared_ptr<WorldPacket> compressed = std::make_shared<WorldPacket>();
+            if (UpdateData::CompressPacket(*queued.packet, *compressed))
+                queued.packet = std::move(compressed);
+        }
+
+        guard.lock();
+
+        for (auto const& queued : queue)
+            WritePacket(queued.packet, queued.immediate);
+    }
+
+    m_sendQueueScheduled = false;
+}
+
+void WorldSocket::WritePacket(const WorldPacket& pct, bool immediate)
+{
+    if (IsClosed())
+        return;
+
     ServerPktHeader header(pct.size() + 2, pct.GetOpcode());
     m_crypt.EncryptSend((uint8*)header.header, header.getHeaderLength());
 
@@ -112,6 +198,24 @@ void WorldSocket::SendPacket(const WorldPacket& pct, bool immediate)
         ForceFlushOut();
 }
 
+void WorldSocket::WritePacket(SharedWorldPacket const& pct, bool immediate)
+{
+    if (IsClosed())
+        return;
+
+    ServerPktHeader header(pct->size() + 2, pct->GetOpcode());
+    m_crypt.EncryptSend((uint8*)header.header, header.getHeaderLength());
+
+    // the header is encrypted per socket, only the body is shared
+    if (pct->size() > 0)
+        Write(reinterpret_cast<const char *>(&header.header), header.getHeaderLength(), std::shared_ptr<const uint8>(pct, pct->contents()), pct->size());
+    else
+        Write(reinterpret_cast<const char *>(&header.header), header.getHeaderLength());
+
+    if (immediate)
+        ForceFlushOut();
+}
+
 bool WorldSocket::Open()
 {
     if (!Socket::Open())
@@ -222,7 +326,7 @@ bool WorldSocket::ProcessIncomingData()
             case 0x4C524F57:
                 return HandleWowConnection(*pct);
             case CMSG_AUTH_SESSION:
-                if (m_session)
+                if (m_session || m_authPending)
                 {
                     sLog.outError("WorldSocket::ProcessIncomingData: Player send CMSG_AUTH_SESSION again");
                     return false;
@@ -284,17 +388,36 @@ bool WorldSocket::ProcessIncomingData()
     return true;
 }
 
+struct WorldSocket::AuthSessionData
+{
+    AuthSessionData() : clientSeed(0), response(AUTH_FAILED), session(nullptr) {}
+    ~AuthSessionData() { delete session; }              // not taken by the socket: it was closed meanwhile
+
+    // from the client
+    uint8 digest[20];
+    uint32 clientSeed;
+    std::string accountName;
+    ByteBuffer addonsData;
+
+    // from the lookup
+    uint8 response;
+    BigNumber s;
+    BigNumber K;
+    WorldSession* session;
+};
+
+static MaNGOS::TaskScheduler s_authWorkers;
+static std::mutex s_authQueueLock;
+static AuthQueueStats s_authQueueStats;
+
 bool WorldSocket::HandleAuthSession(WorldPacket &recvPacket)
 {
     // NOTE: ATM the socket is singlethread, have this in mind ...
     uint8 digest[20];
-    uint16 clientBuild, security;
-    uint32 id, m_addonSize, clientSeed, expansion;
+    uint16 clientBuild;
+    uint32 m_addonSize, clientSeed;
     std::string accountName;
-    LocaleConstant locale;
 
-    Sha1Hash sha1;
-    BigNumber v, s, g, N, K;
     WorldPacket packet;
 
     recvPacket.read_skip<uint32>();
@@ -360,12 +483,96 @@ bool WorldSocket::HandleAuthSession(WorldPacket &recvPacket)
         return false;
     }
 
+    std::shared_ptr<AuthSessionData> data = std::make_shared<AuthSessionData>();
+    memcpy(data->digest, digest, sizeof(digest));
+    data->clientSeed = clientSeed;
+    data->accountName = accountName;
+    data->addonsData = addonsData;
+
+    // the account lookups are left to the auth workers, the network thread only checks the version
+    if (!QueueAuthSession(data))
+    {
+        packet.Initialize (SMSG_AUTH_RESPONSE, 2);
+        packet.WriteBit(false);
+        packet.WriteBit(false);
+        packet << uint8 (AUTH_DB_BUSY);
+
+        SendPacket (packet);
+
+        sLog.outError("WorldSocket::HandleAuthSession: Sent Auth Response (too many clients waiting for authentication).");
+        return false;
+    }
+
+    return true;
+}
+
+bool WorldSocket::QueueAuthSession(std::shared_ptr<AuthSessionData> const& data)
+{
+    {
+        std::lock_guard<std::mutex> guard(s_authQueueLock);
+
+        uint32 const limit = sWorld.getConfig(CONFIG_UINT32_AUTH_SESSION_QUEUE_LIMIT);
+        if (limit && s_authQueueStats.queued >= limit)
+        {
+            ++s_authQueueStats.rejected;
+            return false;
+        }
+
+        if (++s_authQueueStats.queued > s_authQueueStats.maxQueued)
+            s_authQueueStats.maxQueued = s_authQueueStats.queued;
+    }
+
+    m_authPending = true;
+
+    std::chrono::steady_clock::time_point const queueTime = std::chrono::steady_clock::now();
+    std::shared_ptr<WorldSocket> self = shared<WorldSocket>();
+
+    s_authWorkers.Submit([self, data, queueTime]()
+    {
+        std::chrono::steady_clock::time_point const startTime = std::chrono::steady_clock::now();
+
+        // nothing to look up for a client that left while waiting
+        if (!self->IsClosed())
+            self->VerifyAuthSession(*data);
+
+        std::chrono::steady_clock::time_point const endTime = std::chrono::steady_clock::now();
+
+        {
+            uint64 const wait = std::chrono::duration_cast<std::chrono::microseconds>(startTime - queueTime).count();
+            uint64 const time = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+
+            std::lock_guard<std::mutex> guard(s_authQueueLock);
+
+            --s_authQueueStats.queued;
+            ++s_authQueueStats.processed;
+            s_authQueueStats.totalWait += wait;
+            s_authQueueStats.totalTime += time;
+            if (wait > s_authQueueStats.maxWait)
+                s_authQueueStats.maxWait = wait;
+            if (time > s_authQueueStats.maxTime)
+                s_authQueueStats.maxTime = time;
+        }
+
+        boost::asio::post(self->GetAsioSocket().get_executor(), [self, data]()
+        {
+            if (!self->IsClosed())
+                self->FinishAuthSession(*data);
+        });
+    });
+
+    return true;
+}
+
+void WorldSocket::VerifyAuthSession(AuthSessionData& data) const
+{
+    BigNumber v, s, g, N, K;
+
     // Get the account information from the realmd database
-    std::string safe_account = accountName; // Duplicate, else will screw the SHA hash verification below
+    std::string safe_account = data.accountName; // Duplicate, else will screw the SHA hash verification below
     LoginDatabase.escape_string (safe_account);
     // No SQL injection, username escaped.
 
-    QueryResult* result =
+    std::unique_ptr<QueryResult> result(
         LoginDatabase.PQuery("SELECT "
                              "id, "                      //0
                              "gmlevel, "                 //1
@@ -379,32 +586,26 @@ bool WorldSocket::HandleAuthSession(WorldPacket &recvPacket)
                              "locale "                   //9
                              "FROM account "
                              "WHERE username = '%s'",
-                             safe_account.c_str());
+                             safe_account.c_str()));
 
     // Stop if the account is not found
     if (!result)
     {
-        packet.Initialize (SMSG_AUTH_RESPONSE, 2);
-        packet.WriteBit(false);
-        packet.WriteBit(false);
-        packet << uint8 (AUTH_UNKNOWN_ACCOUNT);
-
-        SendPacket (packet);
-
+        data.response = AUTH_UNKNOWN_ACCOUNT;
         sLog.outError("WorldSocket::HandleAuthSession: Sent Auth Response (unknown account).");
-        return false;
+        return;
     }
 
     Field* fields = result->Fetch ();
 
-    expansion = ((sWorld.getConfig(CONFIG_UINT32_EXPANSION) > fields[7].GetUInt8()) ? fields[7].GetUInt8() : sWorld.getConfig(CONFIG_UINT32_EXPANSION));
+    uint32 expansion = ((sWorld.getConfig(CONFIG_UINT32_EXPANSION) > fields[7].GetUInt8()) ? fields[7].GetUInt8() : sWorld.getConfig(CONFIG_UINT32_EXPANSION));
 
     N.SetHexStr("894B645E89E1535BBDAD5B8B290650530801B18EBFBF5E8FAB3C82872A3E9BB7");
     g.SetDword(7);
 
     v.SetHexStr(fields[5].GetString());
     s.SetHexStr(fields[6].GetString());
-    m_s = s;
+    data.s = s;
 
     const char* sStr = s.AsHexStr ();                       //Must be freed by OPENSSL_free()
     const char* vStr = v.AsHexStr ();                       //Must be freed by OPENSSL_free()
@@ -421,20 +622,14 @@ bool WorldSocket::HandleAuthSession(WorldPacket &recvPacket)
     {
         if (strcmp (fields[3].GetString(), GetRemoteAddress().c_str()))
         {
-            packet.Initialize (SMSG_AUTH_RESPONSE, 2);
-            packet.WriteBit(false);
-            packet.WriteBit(false);
-            packet << uint8 (AUTH_FAILED);
-            SendPacket (packet);
-
-            delete result;
+            data.response = AUTH_FAILED;
             BASIC_LOG("WorldSocket::HandleAuthSession: Sent Auth Response (Account IP differs).");
-            return false;
+            return;
         }
     }
 
-    id = fields[0].GetUInt32();
-    security = fields[1].GetUInt16();
+    uint32 id = fields[0].GetUInt32();
+    uint16 security = fields[1].GetUInt16();
     if(security > SEC_ADMINISTRATOR)                        // prevent invalid security settings in DB
         security = SEC_ADMINISTRATOR;
 
@@ -442,33 +637,27 @@ bool WorldSocket::HandleAuthSession(WorldPacket &recvPacket)
 
     time_t mutetime = time_t (fields[8].GetUInt64());
 
+    LocaleConstant locale;
     uint8 tempLoc = LocaleConstant(fields[9].GetUInt8());
     if (tempLoc >= static_cast<uint8>(MAX_LOCALE))
         locale = LOCALE_enUS;
     else
         locale = LocaleConstant(tempLoc);
 
-    delete result;
+    result.reset();
 
     // Re-check account ban (same check as in realmd)
-    QueryResult *banresult =
+    std::unique_ptr<QueryResult> banresult(
           LoginDatabase.PQuery ("SELECT 1 FROM account_banned WHERE account_id = %u AND active = 1 AND (expires_at > UNIX_TIMESTAMP() OR expires_at = banned_at)"
                                 "UNION "
                                 "SELECT 1 FROM ip_banned WHERE (expires_at = banned_at OR expires_at > UNIX_TIMESTAMP()) AND ip = '%s'",
-                                id, GetRemoteAddress().c_str());
+                                id, GetRemoteAddress().c_str()));
 
     if (banresult) // if account banned
     {
-        packet.Initialize (SMSG_AUTH_RESPONSE, 2);
-        packet.WriteBit(false);
-        packet.WriteBit(false);
-        packet << uint8 (AUTH_BANNED);
-        SendPacket (packet);
-
-        delete banresult;
-
+        data.response = AUTH_BANNED;
         sLog.outError("WorldSocket::HandleAuthSession: Sent Auth Response (Account banned).");
-        return false;
+        return;
     }
 
     // Check locked state for server
@@ -476,15 +665,9 @@ bool WorldSocket::HandleAuthSession(WorldPacket &recvPacket)
 
     if (allowedAccountType > SEC_PLAYER && AccountTypes(security) < allowedAccountType)
     {
-        WorldPacket Packet (SMSG_AUTH_RESPONSE, 2);
-        packet.WriteBit(false);
-        packet.WriteBit(false);
-        Packet << uint8 (AUTH_UNAVAILABLE);
-
-        SendPacket (packet);
-
+        data.response = AUTH_UNAVAILABLE;
         BASIC_LOG("WorldSocket::HandleAuthSession: User tries to login but his security level is not enough");
-        return false;
+        return;
     }
 
     // Check that Key and account name are the same on client and server
@@ -493,30 +676,24 @@ bool WorldSocket::HandleAuthSession(WorldPacket &recvPacket)
     uint32 t = 0;
     uint32 seed = m_seed;
 
-    sha.UpdateData (accountName);
+    sha.UpdateData (data.accountName);
     sha.UpdateData ((uint8 *) & t, 4);
-    sha.UpdateData ((uint8 *) & clientSeed, 4);
+    sha.UpdateData ((uint8 *) & data.clientSeed, 4);
     sha.UpdateData ((uint8 *) & seed, 4);
     sha.UpdateBigNumbers (&K, nullptr);
     sha.Finalize ();
 
-    if (memcmp (sha.GetDigest (), digest, 20))
+    if (memcmp (sha.GetDigest (), data.digest, 20))
     {
-        packet.Initialize (SMSG_AUTH_RESPONSE, 2);
-        packet.WriteBit(false);
-        packet.WriteBit(false);
-        packet << uint8 (AUTH_FAILED);
-
-        SendPacket (packet);
-
+        data.response = AUTH_FAILED;
         sLog.outError("WorldSocket::HandleAuthSession: Sent Auth Response (authentification failed).");
-        return false;
+        return;
     }
 
     const std::string &address = GetRemoteAddress();
 
     DEBUG_LOG ("WorldSocket::HandleAuthSession: Client '%s' authenticated successfully from %s.",
-                accountName.c_str (),
+                data.accountName.c_str (),
                 address.c_str ());
 
     // Update the last_ip in the database
@@ -526,17 +703,67 @@ bool WorldSocket::HandleAuthSession(WorldPacket &recvPacket)
     SqlStatement stmt = LoginDatabase.CreateStatement(updAccount, "INSERT INTO account_logons(accountId,ip,loginTime,loginSource) VALUES(?,?,NOW(),?)");
     stmt.PExecute(id, address.c_str(), std::to_string(LOGIN_TYPE_MANGOSD).c_str());
 
-    m_session = new WorldSession(id, this, AccountTypes(security), expansion, mutetime, locale);
+    // the session is not known by anyone yet, its account data can be loaded here as well
+    data.session = new WorldSession(id, const_cast<WorldSocket*>(this), AccountTypes(security), expansion, mutetime, locale);
+    data.session->LoadGlobalAccountData();
+    data.session->LoadTutorialsData();
+
+    data.K = K;
+    data.response = AUTH_OK;
+}
+
+void WorldSocket::FinishAuthSession(AuthSessionData& data)
+{
+    m_authPending = false;
+    m_s = data.s;
 
-    m_crypt.Init(&K);
+    if (data.response != AUTH_OK)
+    {
+        WorldPacket packet(SMSG_AUTH_RESPONSE, 2);
+        packet.WriteBit(false);
+        packet.WriteBit(false);
+        packet << uint8(data.response);
 
-    m_session->LoadGlobalAccountData();
-    m_session->LoadTutorialsData();
-    m_session->ReadAddonsInfo(addonsData);
+        SendPacket(packet);
+
+        Close();
+        return;
+    }
+
+    m_session = data.session;
+    data.session = nullptr;
+
+    m_crypt.Init(&data.K);
+
+    m_session->ReadAddonsInfo(data.addonsData);
 
     sWorld.AddSession(m_session);
+}
 
-    return true;
+void WorldSocket::StartAuthWorkers(uint32 threads)
+{
+    // account checks query the login database, session setup loads account data from the character database
+    s_authWorkers.SetThreadHooks([]()
+    {
+        LoginDatabase.ThreadStart();
+        CharacterDatabase.ThreadStart();
+    }, []()
+    {
+        CharacterDatabase.ThreadEnd();
+        LoginDatabase.ThreadEnd();
+    });
+    s_authWorkers.Start(threads ? threads : 1);
+}
+
+void WorldSocket::StopAuthWorkers()
+{
+    s_authWorkers.Stop();
+}
+
+AuthQueueStats WorldSocket::GetAuthQueueStats()
+{
+    std::lock_guard<std::mutex> guard(s_authQueueLock);
+    return s_authQueueStats;
 }
 
 bool WorldSocket::HandlePing(WorldPacket &recvPacket)
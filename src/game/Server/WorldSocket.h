@@ -31,11 +31,32 @@
 #include "Network/Socket.hpp"
 
 #include <chrono>
+#include <deque>
 #include <functional>
+#include <memory>
+#include <mutex>
 
 class WorldPacket;
 class WorldSession;
 
+/// Account lookups of the connecting clients, times in microseconds
+struct AuthQueueStats
+{
+    AuthQueueStats() : queued(0), maxQueued(0), processed(0), rejected(0), totalWait(0), maxWait(0), totalTime(0), maxTime(0) {}
+
+    uint32 queued;                                          // waiting or being looked up now
+    uint32 maxQueued;
+    uint64 processed;
+    uint64 rejected;                                        // refused because Network.AuthQueueLimit was reached
+    uint64 totalWait;                                       // between CMSG_AUTH_SESSION and the start of the lookup
+    uint64 maxWait;
+    uint64 totalTime;                                       // of the lookups themselves
+    uint64 maxTime;
+};
+
+// immutable packet whose body can be queued on many sockets without being copied
+typedef std::shared_ptr<WorldPacket const> SharedWorldPacket;
+
 /**
  * WorldSocket.
  *
@@ -111,6 +132,25 @@ class WorldSocket : public MaNGOS::Socket
 
         BigNumber m_s;
 
+        struct QueuedPacket
+        {
+            SharedWorldPacket packet;
+            bool immediate;
+        };
+
+        /// Packets left to the network thread: large update packets to compress and everything sent after them
+        std::mutex m_sendQueueLock;
+        std::deque<QueuedPacket> m_sendQueue;
+        bool m_sendQueueScheduled;
+
+        /// Encrypt the header and write the packet to the output buffer, m_sendQueueLock must be held
+        void WritePacket(const WorldPacket& pct, bool immediate);
+        /// Same as above but the packet body is referenced by the output buffer instead of copied
+        void WritePacket(SharedWorldPacket const& pct, bool immediate);
+
+        /// Called in the network thread, compress and write queued packets
+        void ProcessSendQueue();
+
         /// process one incoming packet.
         virtual bool ProcessIncomingData() override;
 		
@@ -120,6 +160,20 @@ class WorldSocket : public MaNGOS::Socket
         /// Called by ProcessIncoming() on CMSG_AUTH_SESSION.
         bool HandleAuthSession(WorldPacket &recvPacket);
 
+        struct AuthSessionData;
+
+        /// Set while the account of the client is looked up, the socket is parked meanwhile
+        bool m_authPending;
+
+        /// Queue the account lookup on the auth workers, false when the queue is full
+        bool QueueAuthSession(std::shared_ptr<AuthSessionData> const& data);
+
+        /// Called on an auth worker, check the account and build the session
+        void VerifyAuthSession(AuthSessionData& data) const;
+
+        /// Called in the network thread with the result of the lookup
+        void FinishAuthSession(AuthSessionData& data);
+
         /// Called by ProcessIncoming() on CMSG_PING.
         bool HandlePing(WorldPacket &recvPacket);
 
@@ -128,6 +182,8 @@ class WorldSocket : public MaNGOS::Socket
 
         // send a packet \o/
         void SendPacket(const WorldPacket& pct, bool immediate = false);
+        // send a packet which may be sent to other sockets too, without copying its body
+        void SendPacket(SharedWorldPacket const& pct, bool immediate = false);
 
         void FinalizeSession() { m_session = nullptr; }
 
@@ -136,6 +192,11 @@ class WorldSocket : public MaNGOS::Socket
         /// Return the session key
         BigNumber &GetSessionKey() { return m_s; }
 
+        /// Account lookups of CMSG_AUTH_SESSION run on these threads, not on the network threads
+        static void StartAuthWorkers(uint32 threads);
+        static void StopAuthWorkers();
+        static AuthQueueStats GetAuthQueueStats();
+
 };
 
 #endif  /* _WORLDSOCKET_H */
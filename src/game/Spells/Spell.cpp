@@ -799,6 +799,8 @@ void Spell::FillTargetMap()
             }
         }
 
+        PrepareTargetsLineOfSight(tmpUnitLists[effToIndex[i]], SpellEffectIndex(i));
+
         for (UnitList::iterator itr = tmpUnitLists[effToIndex[i]].begin(); itr != tmpUnitLists[effToIndex[i]].end();)
         {
             if (!CheckTarget(*itr, SpellEffectIndex(i)))
@@ -7544,6 +7546,53 @@ CurrentSpellTypes Spell::GetCurrentContainer()
         return (CURRENT_GENERIC_SPELL);
 }
 
+/**
+ * Test the line of sight of all area targets in one batch, CheckTarget then finds the results cached by the map
+ */
+void Spell::PrepareTargetsLineOfSight(UnitList const& targetUnitMap, SpellEffectIndex eff)
+{
+    if (targetUnitMap.size() < 2 || IsIgnoreLosSpell(m_spellInfo))
+        return;
+
+    // same source as the normal case of CheckTarget
+    switch (m_spellInfo->Effect[eff])
+    {
+        case SPELL_EFFECT_SUMMON_PLAYER:
+        case SPELL_EFFECT_DUMMY:
+        case SPELL_EFFECT_RESURRECT_NEW:
+            return;
+        default:
+            break;
+    }
+
+    WorldObject* source;
+    if (m_spellInfo->EffectImplicitTargetA[eff] == TARGET_LOCATION_DYNOBJ_POSITION)
+        source = m_caster->GetDynObject(m_triggeredByAuraSpell ? m_triggeredByAuraSpell->Id : m_spellInfo->Id);
+    else
+        source = GetCastingObject();
+
+    if (!source)
+        return;
+
+    float ox, oy, oz;
+    source->GetPosition(ox, oy, oz);
+
+    std::vector<LineOfSightRay> rays;
+    rays.reserve(targetUnitMap.size());
+    for (Unit* target : targetUnitMap)
+    {
+        if (target == m_caster || !target->IsInMap(source))
+            continue;
+
+        float x, y, z;
+        target->GetPosition(x, y, z);
+        rays.emplace_back(x, y, z + 2.0f, ox, oy, oz + 2.0f, target->GetPhaseMask());
+    }
+
+    if (rays.size() > 1)
+        source->GetMap()->IsInLineOfSight(rays);
+}
+
 bool Spell::CheckTarget(Unit* target, SpellEffectIndex eff)
 {
     // Check targets for creature type mask and remove not appropriate (skip explicit self target case, maybe need other explicit targets)
@@ -502,6 +502,7 @@ class Spell
         template<typename T> WorldObject* FindCorpseUsing();
 
         bool CheckTarget(Unit* target, SpellEffectIndex eff);
+        void PrepareTargetsLineOfSight(UnitList const& targetUnitMap, SpellEffectIndex eff);
         bool CanAutoCast(Unit* target);
 
         static void SendCastResult(Player* caster, SpellEntry const* spellInfo, uint8 cast_count, SpellCastResult result, bool isPetCastResult = false);
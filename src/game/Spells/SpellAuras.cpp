@@ -2097,7 +2097,8 @@ void Aura::TriggerSpell()
             }
             case 16191:                                     // Mana Tide
             {
-                triggerTarget->CastCustomSpell(triggerTarget, trigger_spell_id, &m_modifier.m_amount, nullptr, nullptr, TRIGGERED_OLD_TRIGGERED, nullptr, this);
+                int32 bp = m_modifier.m_amount;
+                triggerTarget->CastCustomSpell(triggerTarget, trigger_spell_id, &bp, nullptr, nullptr, TRIGGERED_OLD_TRIGGERED, nullptr, this);
                 return;
             }
             case 33525:                                     // Ground Slam
@@ -4183,7 +4184,7 @@ void Aura::HandleForceReaction(bool apply, bool Real)
     Player* player = (Player*)GetTarget();
 
     uint32 faction_id = m_modifier.m_miscvalue;
-    ReputationRank faction_rank = ReputationRank(m_modifier.m_amount);
+    ReputationRank faction_rank = ReputationRank(int32(m_modifier.m_amount));
 
     player->GetReputationMgr().ApplyForceReaction(faction_id, faction_rank, apply);
     player->GetReputationMgr().SendForceReactions();
@@ -5548,7 +5549,10 @@ void Aura::HandlePeriodicHeal(bool apply, bool /*Real*/)
         // Rejuvenation
         if (GetSpellProto()->IsFitToFamily(SPELLFAMILY_DRUID, uint64(0x0000000000000010)))
             if (caster->HasAura(64760))                     // Item - Druid T8 Restoration 4P Bonus
-                caster->CastCustomSpell(target, 64801, &m_modifier.m_amount, nullptr, nullptr, TRIGGERED_OLD_TRIGGERED, nullptr);
+            {
+                int32 bp = m_modifier.m_amount;
+                caster->CastCustomSpell(target, 64801, &bp, nullptr, nullptr, TRIGGERED_OLD_TRIGGERED, nullptr);
+            }
     }
 }
 
@@ -8537,7 +8541,8 @@ void Aura::PeriodicDummyTick()
             // Explosive Shot
             if (spell->SpellFamilyFlags & uint64(0x8000000000000000))
             {
-                target->CastCustomSpell(target, 53352, &m_modifier.m_amount, nullptr, nullptr, TRIGGERED_OLD_TRIGGERED, nullptr, this, GetCasterGuid());
+                int32 bp = m_modifier.m_amount;
+                target->CastCustomSpell(target, 53352, &bp, nullptr, nullptr, TRIGGERED_OLD_TRIGGERED, nullptr, this, GetCasterGuid());
                 return;
             }
             switch (spell->Id)
@@ -8577,7 +8582,10 @@ void Aura::PeriodicDummyTick()
             if (spell->SpellFamilyFlags & uint64(0x0000000000000020))
             {
                 if (Unit* caster = GetCaster())
-                    caster->CastCustomSpell(target, 52212, &m_modifier.m_amount, nullptr, nullptr, TRIGGERED_OLD_TRIGGERED, nullptr, this);
+                {
+                    int32 bp = m_modifier.m_amount;
+                    caster->CastCustomSpell(target, 52212, &bp, nullptr, nullptr, TRIGGERED_OLD_TRIGGERED, nullptr, this);
+                }
                 return;
             }
             // Raise Dead
@@ -23,6 +23,44 @@
 #include "Entities/ObjectGuid.h"
 #include "Util/UniqueTrackablePtr.h"
 
+class AuraTypeList;
+
+/**
+ * Amount of a Modifier. Behaves like an int32, but makes the aura list
+ * of the target compute its totals again when it is changed.
+ * \see AuraTypeList::GetTotals
+ */
+class ModifierAmount
+{
+    public:
+        ModifierAmount() : m_value(0), m_list(nullptr) {}
+        ModifierAmount(ModifierAmount const& other) : m_value(other.m_value), m_list(nullptr) {}
+
+        operator int32() const { return m_value; }
+
+        ModifierAmount& operator=(ModifierAmount const& other) { return *this = other.m_value; }
+        ModifierAmount& operator=(int32 value) { m_value = value; Changed(); return *this; }
+        // computed like for an int32, ie. in float for a float value
+        template<typename T> ModifierAmount& operator+=(T value) { m_value += value; Changed(); return *this; }
+        template<typename T> ModifierAmount& operator-=(T value) { m_value -= value; Changed(); return *this; }
+        template<typename T> ModifierAmount& operator*=(T value) { m_value *= value; Changed(); return *this; }
+        template<typename T> ModifierAmount& operator/=(T value) { m_value /= value; Changed(); return *this; }
+        ModifierAmount& operator++() { ++m_value; Changed(); return *this; }
+        ModifierAmount& operator--() { --m_value; Changed(); return *this; }
+        int32 operator++(int) { int32 old = m_value; ++*this; return old; }
+        int32 operator--(int) { int32 old = m_value; --*this; return old; }
+
+        // set while the aura is in the list of its type of the target
+        void SetList(AuraTypeList* list) { m_list = list; }
+
+    private:
+        void Changed() { if (m_list) NotifyList(); }
+        void NotifyList();
+
+        int32 m_value;
+        AuraTypeList* m_list;
+};
+
 /**
  * Used to modify what an Aura does to a player/npc.
  * Accessible through Aura::m_modifier.
@@ -45,7 +83,7 @@ struct Modifier
      * be reduced by 27% if the earlier mentioned AuraType
      * would have been used. And 27 would increase the value by 27%
      */
-    int32 m_amount;
+    ModifierAmount m_amount;
     /**
      * A miscvalue that is dependent on what the aura will do, this
      * is usually decided by the AuraType, ie:
@@ -397,12 +397,13 @@ void WorldSession::HandleCastSpellOpcode(WorldPacket& recvPacket)
         }
     }
 
-    Unit::AuraList swaps = mover->GetAurasByType(SPELL_AURA_OVERRIDE_ACTIONBAR_SPELLS);
+    Unit::AuraList const& swaps1 = mover->GetAurasByType(SPELL_AURA_OVERRIDE_ACTIONBAR_SPELLS);
     Unit::AuraList const& swaps2 = mover->GetAurasByType(SPELL_AURA_OVERRIDE_ACTIONBAR_SPELLS_2);
+    std::list<Aura*> swaps(swaps1.begin(), swaps1.end());
     if (!swaps2.empty())
         swaps.insert(swaps.end(), swaps2.begin(), swaps2.end());
 
-    for (Unit::AuraList::const_iterator itr = swaps.begin(); itr != swaps.end(); ++itr)
+    for (std::list<Aura*>::const_iterator itr = swaps.begin(); itr != swaps.end(); ++itr)
     {
         if ((*itr)->isAffectedOnSpell(spellInfo))
         {
@@ -29,6 +29,9 @@
 
 using G3D::Vector3;
 
+// models collected for a batch of line of sight segments before each segment walks the tree again
+#define MAX_LOS_SHARED_MODELS 32
+
 namespace VMAP
 {
     class MapRayCallback
@@ -48,6 +51,15 @@ namespace VMAP
             ModelInstance* prims;
     };
 
+    class ModelCollectCallback
+    {
+        public:
+            ModelCollectCallback(std::vector<uint32>& val): entries(val) {}
+            void operator()(uint32 entry) { entries.push_back(entry); }
+
+            std::vector<uint32>& entries;
+    };
+
     class AreaInfoCallback
     {
         public:
@@ -166,6 +178,60 @@ namespace VMAP
 
         return true;
     }
+
+    void StaticMapTree::isInLineOfSight(std::vector<LineOfSightSegment>& segments) const
+    {
+        G3D::AABox bounds;
+        bool hasBounds = false;
+        for (LineOfSightSegment& segment : segments)
+        {
+            segment.result = true;
+            if ((segment.pos2 - segment.pos1).squaredMagnitude() < 1e-20f)
+                continue;
+            G3D::AABox segmentBounds(segment.pos1.min(segment.pos2), segment.pos1.max(segment.pos2));
+            if (hasBounds)
+                bounds.merge(segmentBounds);
+            else
+                bounds = segmentBounds;
+            hasBounds = true;
+        }
+
+        if (!hasBounds)
+            return;
+
+        std::vector<uint32> entries;
+        ModelCollectCallback collectCallback(entries);
+        iTree.intersectBox(bounds, collectCallback);
+
+        // segments far apart collect too many models, walking the tree per segment is cheaper then
+        if (entries.size() > MAX_LOS_SHARED_MODELS)
+        {
+            for (LineOfSightSegment& segment : segments)
+                segment.result = isInLineOfSight(segment.pos1, segment.pos2);
+            return;
+        }
+
+        if (entries.empty())
+            return;
+
+        for (LineOfSightSegment& segment : segments)
+        {
+            float maxDist = (segment.pos2 - segment.pos1).magnitude();
+            MANGOS_ASSERT(maxDist < std::numeric_limits<float>::max());
+            if (maxDist < 1e-10f)
+                continue;
+            G3D::Ray ray = G3D::Ray::fromOriginAndDirection(segment.pos1, (segment.pos2 - segment.pos1) / maxDist);
+            for (uint32 entry : entries)
+            {
+                float distance = maxDist;
+                if (iTreeValues[entry].intersectRay(ray, distance, true, true))
+                {
+                    segment.result = false;
+                    break;
+                }
+            }
+        }
+    }
     //=========================================================
     /**
     When moving from pos1 to pos2 check if we hit an object. Return true and the position if we hit one
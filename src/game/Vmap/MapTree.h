@@ -37,6 +37,13 @@ namespace VMAP
         float ground_Z;
     };
 
+    struct LineOfSightSegment
+    {
+        G3D::Vector3 pos1;
+        G3D::Vector3 pos2;
+        bool result;
+    };
+
     class StaticMapTree
     {
             typedef std::unordered_map<uint32, bool> loadedTileMap;
@@ -69,6 +76,8 @@ namespace VMAP
             ~StaticMapTree();
 
             bool isInLineOfSight(G3D::Vector3 const& pos1, G3D::Vector3 const& pos2) const;
+            // test all segments against the models found by one walk of the tree over their common bounds
+            void isInLineOfSight(std::vector<LineOfSightSegment>& segments) const;
             bool getObjectHitPos(G3D::Vector3 const& pos1, G3D::Vector3 const& pos2, G3D::Vector3& pResultHitPos, float pModifyDist) const;
             float getHeight(G3D::Vector3 const& pPos, float maxSearchDist) const;
             bool getAreaInfo(G3D::Vector3& pos, uint32& flags, int32& adtId, int32& rootId, int32& groupId) const;
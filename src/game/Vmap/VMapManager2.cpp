@@ -153,6 +153,30 @@ namespace VMAP
         }
         return result;
     }
+
+    void VMapManager2::isInLineOfSight(unsigned int pMapId, std::vector<LineOfSightQuery>& queries)
+    {
+        for (LineOfSightQuery& query : queries)
+            query.result = true;
+
+        if (!isLineOfSightCalcEnabled())
+            return;
+        InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
+        if (instanceTree == iInstanceMapTrees.end())
+            return;
+
+        std::vector<LineOfSightSegment> segments(queries.size());
+        for (size_t i = 0; i < queries.size(); ++i)
+        {
+            segments[i].pos1 = convertPositionToInternalRep(queries[i].x1, queries[i].y1, queries[i].z1);
+            segments[i].pos2 = convertPositionToInternalRep(queries[i].x2, queries[i].y2, queries[i].z2);
+        }
+
+        instanceTree->second->isInLineOfSight(segments);
+
+        for (size_t i = 0; i < queries.size(); ++i)
+            queries[i].result = segments[i].result;
+    }
     //=========================================================
     /**
     get the hit position and return true if we hit something
@@ -86,6 +86,7 @@ namespace VMAP
             void unloadMap(unsigned int pMapId) override;
 
             bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2) override;
+            void isInLineOfSight(unsigned int pMapId, std::vector<LineOfSightQuery>& queries) override;
             /**
             fill the hit pos and return true, if an object was hit
             */
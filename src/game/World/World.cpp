@@ -55,6 +55,7 @@
 #include "OutdoorPvP/OutdoorPvP.h"
 #include "Vmap/VMapFactory.h"
 #include "MotionGenerators/MoveMap.h"
+#include "MotionGenerators/PathFinder.h"
 #include "GameEvents/GameEventMgr.h"
 #include "Pools/PoolManager.h"
 #include "Database/DatabaseImpl.h"
@@ -70,6 +71,8 @@
 #include "Calendar/Calendar.h"
 #include "Weather/Weather.h"
 #include "World/WorldState.h"
+#include "Multithreading/TaskScheduler.h"
+#include "Multithreading/TaskGraph.h"
 
 #ifdef BUILD_ELUNA
 #include "LuaEngine/LuaEngine.h"
@@ -156,7 +159,10 @@ void World::CleanupsBeforeStop()
     KickAll();                                       // save and kick all players
     UpdateSessions(1);                               // real players unload required UpdateSessions call
     sBattleGroundMgr.DeleteAllBattleGrounds();       // unload battleground templates before different singletons destroyed
+    TerrainManager::StopPrefetchWorkers();           // no terrain loading left before terrain unload
+    PathFinder::StopWorkers();                       // no navmesh use left before navmesh unload
     sMapMgr.UnloadAll();                             // unload all grids (including locked in memory)
+    sTaskScheduler.Stop();                           // no more parallel jobs after this point
 }
 
 /// Find a session by its id
@@ -498,6 +504,7 @@ void World::LoadConfigSettings(bool reload)
 
     ///- Read other configuration items from the config file
     setConfigMinMax(CONFIG_UINT32_COMPRESSION, "Compression", 1, 1, 9);
+    setConfig(CONFIG_UINT32_COMPRESSION_THRESHOLD, "CompressionThreshold", 0);
     setConfig(CONFIG_BOOL_ADDON_CHANNEL, "AddonChannel", true);
     setConfig(CONFIG_BOOL_CLEAN_CHARACTER_DB, "CleanCharacterDB", true);
     setConfig(CONFIG_BOOL_GRID_UNLOAD, "GridUnload", true);
@@ -525,6 +532,22 @@ void World::LoadConfigSettings(bool reload)
     if (reload)
         sMapMgr.SetMapUpdateInterval(getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE));
 
+    if (configNoReload(reload, CONFIG_UINT32_MAP_UPDATE_THREADS, "MapUpdateThreads", 0))
+        setConfig(CONFIG_UINT32_MAP_UPDATE_THREADS, "MapUpdateThreads", 0);
+
+    if (configNoReload(reload, CONFIG_UINT32_WORKER_THREADS, "WorkerThreads", 0))
+        setConfig(CONFIG_UINT32_WORKER_THREADS, "WorkerThreads", 0);
+
+    if (configNoReload(reload, CONFIG_UINT32_GRID_PREFETCH_THREADS, "GridPrefetchThreads", 1))
+        setConfig(CONFIG_UINT32_GRID_PREFETCH_THREADS, "GridPrefetchThreads", 1);
+
+    if (configNoReload(reload, CONFIG_UINT32_CHARACTER_DB_ASYNC_ROUTING, "CharacterDatabaseAsyncRouting", CHARACTER_DB_ROUTING_CHARACTER))
+        setConfigMinMax(CONFIG_UINT32_CHARACTER_DB_ASYNC_ROUTING, "CharacterDatabaseAsyncRouting", CHARACTER_DB_ROUTING_CHARACTER, CHARACTER_DB_ROUTING_NONE, CHARACTER_DB_ROUTING_ACCOUNT);
+
+    setConfig(CONFIG_BOOL_PARALLEL_STARTUP_LOADING, "ParallelStartupLoading", true);
+
+    SQLStorageBase::SetCacheDirectory(sConfig.GetStringDefault("SQLStorageCacheDir", ""));
+
     setConfig(CONFIG_UINT32_INTERVAL_CHANGEWEATHER, "ChangeWeatherInterval", 10 * MINUTE * IN_MILLISECONDS);
 
     if (configNoReload(reload, CONFIG_UINT32_PORT_WORLD, "WorldServerPort", DEFAULT_WORLDSERVER_PORT))
@@ -747,6 +770,7 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_BOOL_OFFHAND_CHECK_AT_TALENTS_RESET, "OffhandCheckAtTalentsReset", false);
 
     setConfig(CONFIG_BOOL_KICK_PLAYER_ON_BAD_PACKET, "Network.KickOnBadPacket", false);
+    setConfig(CONFIG_UINT32_AUTH_SESSION_QUEUE_LIMIT, "Network.AuthQueueLimit", 1000);
 
     setConfig(CONFIG_BOOL_PLAYER_COMMANDS, "PlayerCommands", true);
 
@@ -897,6 +921,8 @@ void World::LoadConfigSettings(bool reload)
 
     setConfig(CONFIG_BOOL_PATH_FIND_OPTIMIZE, "PathFinder.OptimizePath", true);
     setConfig(CONFIG_BOOL_PATH_FIND_NORMALIZE_Z, "PathFinder.NormalizeZ", false);
+    if (configNoReload(reload, CONFIG_UINT32_PATH_FIND_THREADS, "PathFinder.Threads", 1))
+        setConfig(CONFIG_UINT32_PATH_FIND_THREADS, "PathFinder.Threads", 1);
 
 #ifdef BUILD_ELUNA
     if (reload)
@@ -909,6 +935,52 @@ void World::LoadConfigSettings(bool reload)
     sLog.outString();
 }
 
+/// Load the startup data which does not depend on each other concurrently on the worker pool
+void World::LoadStartupGraph()
+{
+    MaNGOS::TaskGraph graph("Startup data");
+
+    // pool threads have their own mysql thread data (see SetInitialWorldSettings), sync queries are spread over the WorldDatabaseConnections pool
+
+    // loot stores only read their own table, validation is done against already loaded templates
+    graph.AddStage("LootTemplates_Creature", {}, &LoadLootTemplates_Creature);
+    graph.AddStage("LootTemplates_Fishing", {}, &LoadLootTemplates_Fishing);
+    graph.AddStage("LootTemplates_Gameobject", {}, &LoadLootTemplates_Gameobject);
+    graph.AddStage("LootTemplates_Item", {}, &LoadLootTemplates_Item);
+    graph.AddStage("LootTemplates_Mail", {}, &LoadLootTemplates_Mail);
+    graph.AddStage("LootTemplates_Milling", {}, &LoadLootTemplates_Milling);
+    graph.AddStage("LootTemplates_Pickpocketing", {}, &LoadLootTemplates_Pickpocketing);
+    graph.AddStage("LootTemplates_Skinning", {}, &LoadLootTemplates_Skinning);
+    graph.AddStage("LootTemplates_Disenchant", {}, &LoadLootTemplates_Disenchant);
+    graph.AddStage("LootTemplates_Prospecting", {}, &LoadLootTemplates_Prospecting);
+    graph.AddStage("LootTemplates_Spell", {}, &LoadLootTemplates_Spell);
+    // reference loot checks references of all other stores
+    graph.AddStage("LootTemplates_Reference", { "LootTemplates_Creature", "LootTemplates_Fishing", "LootTemplates_Gameobject",
+        "LootTemplates_Item", "LootTemplates_Mail", "LootTemplates_Milling", "LootTemplates_Pickpocketing", "LootTemplates_Skinning",
+        "LootTemplates_Disenchant", "LootTemplates_Prospecting", "LootTemplates_Spell" }, &LoadLootTemplates_Reference);
+
+    graph.AddStage("SkillDiscoveryTable", {}, &LoadSkillDiscoveryTable);
+    graph.AddStage("SkillExtraItemTable", {}, &LoadSkillExtraItemTable);
+    graph.AddStage("FishingBaseSkillLevel", {}, []() { sObjectMgr.LoadFishingBaseSkillLevel(); });
+
+    graph.AddStage("AchievementReferenceList", {}, []() { sAchievementMgr.LoadAchievementReferenceList(); });
+    graph.AddStage("AchievementCriteriaList", { "AchievementReferenceList" }, []() { sAchievementMgr.LoadAchievementCriteriaList(); });
+    graph.AddStage("AchievementCriteriaRequirements", { "AchievementCriteriaList" }, []() { sAchievementMgr.LoadAchievementCriteriaRequirements(); });
+    graph.AddStage("AchievementRewards", { "AchievementReferenceList" }, []() { sAchievementMgr.LoadRewards(); });
+    graph.AddStage("AchievementRewardLocales", { "AchievementRewards" }, []() { sAchievementMgr.LoadRewardLocales(); });
+    graph.AddStage("CompletedAchievements", { "AchievementReferenceList" }, []() { sAchievementMgr.LoadCompletedAchievements(); });
+
+    if (getConfig(CONFIG_BOOL_PARALLEL_STARTUP_LOADING))
+        graph.Run(sTaskScheduler);
+    else
+    {
+        MaNGOS::TaskScheduler inlineScheduler;              // not started, every stage runs in this thread
+        graph.Run(inlineScheduler);
+    }
+
+    graph.LogTimings();
+}
+
 /// Initialize the World
 void World::SetInitialWorldSettings()
 {
@@ -924,6 +996,26 @@ void World::SetInitialWorldSettings()
     ///- Initialize config settings
     LoadConfigSettings();
 
+    ///- Start the worker pool shared by map updates and other parallel jobs, all of them may query the databases
+    sTaskScheduler.SetThreadHooks([]()
+    {
+        WorldDatabase.ThreadStart();
+        CharacterDatabase.ThreadStart();
+        LoginDatabase.ThreadStart();
+    }, []()
+    {
+        LoginDatabase.ThreadEnd();
+        CharacterDatabase.ThreadEnd();
+        WorldDatabase.ThreadEnd();
+    });
+    sTaskScheduler.Start(getConfig(CONFIG_UINT32_WORKER_THREADS));
+
+    ///- Start the threads loading terrain ahead of moving players
+    TerrainManager::StartPrefetchWorkers(getConfig(CONFIG_UINT32_GRID_PREFETCH_THREADS));
+
+    ///- Start the threads calculating the paths of chasing and following units
+    PathFinder::StartWorkers(getConfig(CONFIG_UINT32_PATH_FIND_THREADS));
+
     ///- Check the existence of the map files for all races start areas.
     if (!MapManager::ExistMapAndVMap(0, -6240.32f, 331.033f) ||                     // Dwarf/ Gnome
             !MapManager::ExistMapAndVMap(0, -8949.95f, -132.493f) ||                // Human
@@ -1221,28 +1313,9 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading Player level dependent mail rewards...");
     sObjectMgr.LoadMailLevelRewards();
 
-    sLog.outString("Loading Loot Tables...");
-    LoadLootTables();
-    sLog.outString(">>> Loot Tables loaded");
-    sLog.outString();
-
-    sLog.outString("Loading Skill Discovery Table...");
-    LoadSkillDiscoveryTable();
-
-    sLog.outString("Loading Skill Extra Item Table...");
-    LoadSkillExtraItemTable();
-
-    sLog.outString("Loading Skill Fishing base level requirements...");
-    sObjectMgr.LoadFishingBaseSkillLevel();
-
-    sLog.outString("Loading Achievements...");
-    sAchievementMgr.LoadAchievementReferenceList();
-    sAchievementMgr.LoadAchievementCriteriaList();
-    sAchievementMgr.LoadAchievementCriteriaRequirements();
-    sAchievementMgr.LoadRewards();
-    sAchievementMgr.LoadRewardLocales();
-    sAchievementMgr.LoadCompletedAchievements();
-    sLog.outString(">>> Achievements loaded");
+    sLog.outString("Loading Loot Tables, Skill Tables and Achievements...");
+    LoadStartupGraph();
+    sLog.outString(">>> Loot Tables, Skill Tables and Achievements loaded");
     sLog.outString();
 
     sLog.outString("Loading Instance encounters data...");  // must be after Creature loading
@@ -2036,6 +2109,34 @@ void World::UpdateSessions(uint32 /*diff*/)
         m_sessionAddQueue.clear();
     }
 
+    ///- Answer thread-safe packets (queries) of all sessions in parallel, nothing else runs at this point of the tick
+    {
+        std::vector<WorldSession*> sessions;
+        sessions.reserve(m_sessions.size());
+        for (auto const& itr : m_sessions)
+            sessions.push_back(itr.second);
+
+        bool parallel = true;
+#ifdef BUILD_ELUNA
+        // the packet hooks of Eluna share one Lua state, which must not be entered from several threads
+        if (GetEluna())
+            parallel = false;
+#endif
+
+        if (parallel)
+        {
+            sTaskScheduler.ParallelFor(0, sessions.size(), 0, [&sessions](size_t i)
+            {
+                sessions[i]->UpdateThreadSafePackets();
+            });
+        }
+        else
+        {
+            for (WorldSession* session : sessions)
+                session->UpdateThreadSafePackets();
+        }
+    }
+
     ///- Then send an update signal to remaining ones
     for (SessionMap::iterator itr = m_sessions.begin(); itr != m_sessions.end(); )
     {
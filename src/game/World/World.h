@@ -76,6 +76,14 @@ enum ShutdownExitCode
     RESTART_EXIT_CODE  = 2,
 };
 
+/// How character database writes are spread over the async connections
+enum CharacterDBAsyncRouting
+{
+    CHARACTER_DB_ROUTING_NONE      = 0,                     // every write is ordered against every other one
+    CHARACTER_DB_ROUTING_CHARACTER = 1,                     // saves of different characters may run in parallel
+    CHARACTER_DB_ROUTING_ACCOUNT   = 2,                     // saves of different accounts may run in parallel
+};
+
 /// Timers for different object refresh rates
 enum WorldTimers
 {
@@ -93,9 +101,16 @@ enum WorldTimers
 enum eConfigUInt32Values
 {
     CONFIG_UINT32_COMPRESSION = 0,
+    CONFIG_UINT32_COMPRESSION_THRESHOLD,
     CONFIG_UINT32_INTERVAL_SAVE,
     CONFIG_UINT32_INTERVAL_GRIDCLEAN,
     CONFIG_UINT32_INTERVAL_MAPUPDATE,
+    CONFIG_UINT32_MAP_UPDATE_THREADS,
+    CONFIG_UINT32_WORKER_THREADS,
+    CONFIG_UINT32_GRID_PREFETCH_THREADS,
+    CONFIG_UINT32_PATH_FIND_THREADS,
+    CONFIG_UINT32_CHARACTER_DB_ASYNC_ROUTING,
+    CONFIG_UINT32_AUTH_SESSION_QUEUE_LIMIT,
     CONFIG_UINT32_INTERVAL_CHANGEWEATHER,
     CONFIG_UINT32_PORT_WORLD,
     CONFIG_UINT32_GAME_TYPE,
@@ -363,6 +378,7 @@ enum eConfigBoolValues
     CONFIG_BOOL_PLAYER_COMMANDS,
     CONFIG_BOOL_PATH_FIND_OPTIMIZE,
     CONFIG_BOOL_PATH_FIND_NORMALIZE_Z,
+    CONFIG_BOOL_PARALLEL_STARTUP_LOADING,
     CONFIG_BOOL_VALUE_COUNT
 };
 
@@ -681,6 +697,7 @@ class World
         LocaleConstant m_defaultDbcLocale;                  // from config for one from loaded DBC locales
         uint32 m_availableDbcLocaleMask;                    // by loaded DBC
         void DetectDBCLang();
+        void LoadStartupGraph();
         bool m_allowMovement;
         std::string m_motd;
         std::string m_dataPath;
@@ -31,10 +31,13 @@
 #include "AuthCodes.h"
 #include "Auth/SRP6.h"
 #include "Util/CommonDefines.h"
+#include "Multithreading/TaskScheduler.h"
 
 #include <openssl/md5.h>
 #include <ctime>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <utility>
 
 //#include "Util/Util.h" -- for commented utf8ToUpperOnlyLatin
@@ -177,12 +180,110 @@ typedef struct AuthHandler
 
 std::array<uint8, 16> VersionChallenge = { { 0xBA, 0xA3, 0x1E, 0x99, 0xA0, 0x0B, 0x21, 0x57, 0xFC, 0x37, 0x3F, 0xB3, 0x69, 0xCD, 0xD2, 0xF1 } };
 
+/// Characters per realm of the recently authenticated accounts, realm list refreshes are answered without the database
+class CharacterCountCache
+{
+    public:
+        typedef std::shared_ptr<CharacterCounts const> CountsPtr;
+
+        /// Load the counts of the account and store them, called on a database worker
+        CountsPtr Load(uint32 accountId)
+        {
+            std::shared_ptr<CharacterCounts> counts = std::make_shared<CharacterCounts>();
+
+            // No SQL injection. id of account is controlled by the database.
+            if (QueryResult* result = LoginDatabase.PQuery("SELECT realmid, numchars FROM realmcharacters WHERE acctid = '%u'", accountId))
+            {
+                do
+                {
+                    Field* fields = result->Fetch();
+                    (*counts)[fields[0].GetUInt32()] = fields[1].GetUInt8();
+                }
+                while (result->NextRow());
+
+                delete result;
+            }
+
+            std::lock_guard<std::mutex> guard(m_lock);
+
+            time_t const now = time(nullptr);
+
+            Entry& entry = m_accounts[accountId];
+            entry.counts = counts;
+            entry.expireTime = now + m_cacheTime;
+
+            // forget the accounts that left, done on insertion to keep lookups cheap
+            if (m_accounts.size() > m_cleanupSize)
+            {
+                for (auto itr = m_accounts.begin(); itr != m_accounts.end();)
+                {
+                    if (itr->second.expireTime <= now)
+                        itr = m_accounts.erase(itr);
+                    else
+                        ++itr;
+                }
+
+                m_cleanupSize = std::max<size_t>(m_accounts.size() * 2, 1024);
+            }
+
+            return counts;
+        }
+
+        /// Counts of the account, nullptr when they are unknown or too old
+        CountsPtr Find(uint32 accountId)
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+
+            auto itr = m_accounts.find(accountId);
+            if (itr == m_accounts.end() || itr->second.expireTime <= time(nullptr))
+                return nullptr;
+
+            return itr->second.counts;
+        }
+
+        void SetCacheTime(uint32 seconds) { m_cacheTime = seconds; }
+
+    private:
+        struct Entry
+        {
+            CountsPtr counts;
+            time_t expireTime;
+        };
+
+        std::mutex m_lock;
+        std::unordered_map<uint32, Entry> m_accounts;
+        size_t m_cleanupSize = 1024;
+        uint32 m_cacheTime = 60;
+};
+
+static CharacterCountCache sCharacterCountCache;
+
+void AuthSocket::SetCharacterCountCacheTime(uint32 seconds)
+{
+    sCharacterCountCache.SetCacheTime(seconds);
+}
+
 /// Constructor - set the N and g values for SRP6
 AuthSocket::AuthSocket(boost::asio::io_context& context, std::function<void (Socket*)> closeHandler)
-    : Socket(context, std::move(closeHandler)), _status(STATUS_CHALLENGE), _build(0), _accountSecurityLevel(SEC_PLAYER), m_timeoutTimer(context)
+    : Socket(context, std::move(closeHandler)), _status(STATUS_CHALLENGE), _accountId(0), _build(0), _accountSecurityLevel(SEC_PLAYER), m_timeoutTimer(context)
 {
 }
 
+void AuthSocket::DatabaseRequest(std::function<void()> query, std::function<void()> continuation)
+{
+    std::shared_ptr<AuthSocket> self = shared<AuthSocket>();
+    sTaskScheduler.Submit([self, query, continuation]()
+    {
+        query();
+
+        boost::asio::post(self->GetAsioSocket().get_executor(), [self, continuation]()
+        {
+            if (!self->IsClosed())
+                continuation();
+        });
+    });
+}
+
 bool AuthSocket::Open()
 {
     m_timeoutTimer.expires_from_now(boost::posix_time::seconds(30));
@@ -351,8 +452,6 @@ bool AuthSocket::_HandleLogonChallenge()
     EndianConvert(ch->timezone_bias);
     EndianConvert(ch->ip);
 
-    ByteBuffer pkt;
-
     _login = (const char*)ch->I;
     _build = ch->build;
 
@@ -379,25 +478,51 @@ bool AuthSocket::_HandleLogonChallenge()
     LoginDatabase.escape_string(_safelocale);
     LoginDatabase.escape_string(m_os);
 
+    std::shared_ptr<LogonChallengeData> data = std::make_shared<LogonChallengeData>();
+    std::string const address = m_address;
+    std::string const safelogin = _safelogin;
+
+    DatabaseRequest([data, address, safelogin]()
+    {
+        ///- Verify that this IP is not in the ip_banned table
+        // No SQL injection possible (paste the IP address as passed by the socket)
+        std::unique_ptr<QueryResult> ip_banned_result(LoginDatabase.PQuery("SELECT expires_at FROM ip_banned "
+                "WHERE (expires_at = banned_at OR expires_at > UNIX_TIMESTAMP()) AND ip = '%s'", address.c_str()));
+
+        data->ipBanned = bool(ip_banned_result);
+        if (data->ipBanned)
+            return;
+
+        ///- Get the account details from the account table
+        // No SQL injection (escaped user name)
+        data->account.reset(LoginDatabase.PQuery("SELECT id,locked,lockedIp,gmlevel,v,s,token FROM account WHERE username = '%s'", safelogin.c_str()));
+        if (!data->account)
+            return;
+
+        data->accountBan.reset(LoginDatabase.PQuery("SELECT banned_at,expires_at FROM account_banned WHERE "
+                               "account_id = %u AND active = 1 AND (expires_at > UNIX_TIMESTAMP() OR expires_at = banned_at)", (*data->account)[0].GetUInt32()));
+    },
+    [this, data]() { _ContinueLogonChallenge(*data); });
+
+    return true;
+}
+
+/// Answer the logon challenge once the account is loaded
+void AuthSocket::_ContinueLogonChallenge(LogonChallengeData const& data)
+{
+    ByteBuffer pkt;
+
     pkt << uint8(CMD_AUTH_LOGON_CHALLENGE);
     pkt << uint8(0x00);
 
-    ///- Verify that this IP is not in the ip_banned table
-    // No SQL injection possible (paste the IP address as passed by the socket)
-    std::unique_ptr<QueryResult> ip_banned_result(LoginDatabase.PQuery("SELECT expires_at FROM ip_banned "
-            "WHERE (expires_at = banned_at OR expires_at > UNIX_TIMESTAMP()) AND ip = '%s'", m_address.c_str()));
-
-    if (ip_banned_result)
+    if (data.ipBanned)
     {
         pkt << uint8(AUTH_LOGON_FAILED_FAIL_NOACCESS);
         BASIC_LOG("[AuthChallenge] Banned ip %s tries to login!", m_address.c_str());
     }
     else
     {
-        ///- Get the account details from the account table
-        // No SQL injection (escaped user name)
-        QueryResult* result = LoginDatabase.PQuery("SELECT id,locked,lockedIp,gmlevel,v,s,token FROM account WHERE username = '%s'", _safelogin.c_str());
-        if (result)
+        if (QueryResult* result = data.account.get())
         {
             Field* fields = result->Fetch();
 
@@ -433,9 +558,7 @@ bool AuthSocket::_HandleLogonChallenge()
             if (!locked && !broken)
             {
                 ///- If the account is banned, reject the logon attempt
-                QueryResult* banresult = LoginDatabase.PQuery("SELECT banned_at,expires_at FROM account_banned WHERE "
-                                         "account_id = %u AND active = 1 AND (expires_at > UNIX_TIMESTAMP() OR expires_at = banned_at)", fields[0].GetUInt32());
-                if (banresult)
+                if (QueryResult* banresult = data.accountBan.get())
                 {
                     if ((*banresult)[0].GetUInt64() == (*banresult)[1].GetUInt64())
                     {
@@ -447,8 +570,6 @@ bool AuthSocket::_HandleLogonChallenge()
                         pkt << uint8(AUTH_LOGON_FAILED_SUSPENDED);
                         BASIC_LOG("[AuthChallenge] Temporarily banned account %s tries to login!", _login.c_str());
                     }
-
-                    delete banresult;
                 }
                 else
                 {
@@ -499,19 +620,18 @@ bool AuthSocket::_HandleLogonChallenge()
 
                     uint8 secLevel = fields[3].GetUInt8();
                     _accountSecurityLevel = secLevel <= SEC_ADMINISTRATOR ? AccountTypes(secLevel) : SEC_ADMINISTRATOR;
+                    _accountId = fields[0].GetUInt32();
 
                     ///- All good, await client's proof
                     _status = STATUS_LOGON_PROOF;
                 }
             }
-            delete result;
         }
         else                                                // no account
             pkt << uint8(AUTH_LOGON_FAILED_UNKNOWN_ACCOUNT);
     }
 
     Write((const char*)pkt.contents(), pkt.size());
-    return true;
 }
 
 /// Logon Proof command handler
@@ -598,20 +718,36 @@ bool AuthSocket::_HandleLogonProof()
         ///- Update the sessionkey, current ip and login time and reset number of failed logins in the account table for this account
         // No SQL injection (escaped user input) and IP address as received by socket
         const char* K_hex = srp.GetStrongSessionKey().AsHexStr();
-        LoginDatabase.PExecute("UPDATE account SET sessionkey = '%s', locale = '%s', failed_logins = 0, os = '%s', platform = '%s' WHERE username = '%s'", K_hex, _safelocale.c_str(), m_os.c_str(), m_platform.c_str(), _safelogin.c_str());
-        std::unique_ptr<QueryResult> loginfail(LoginDatabase.PQuery("SELECT id FROM account WHERE username = '%s'", _safelogin.c_str()));
-        if (loginfail)
-            LoginDatabase.PExecute("INSERT INTO account_logons(accountId,ip,loginTime,loginSource) VALUES('%u','%s',NOW(),'%u')", loginfail->Fetch()[0].GetUInt32(), m_address.c_str(), LOGIN_TYPE_REALMD);
+        std::string const sessionKey = K_hex;
         OPENSSL_free((void*)K_hex);
 
-        ///- Finish SRP6 and send the final result to the client
-        Sha1Hash sha;
-        srp.Finalize(sha);
+        std::string const safelocale = _safelocale;
+        std::string const os = m_os;
+        std::string const platform = m_platform;
+        std::string const safelogin = _safelogin;
+        std::string const address = m_address;
+        uint32 const accountId = _accountId;
 
-        SendProof(sha);
+        DatabaseRequest([sessionKey, safelocale, os, platform, safelogin, address, accountId]()
+        {
+            // stored before the proof is sent, the world server needs the session key as soon as the client connects to it
+            LoginDatabase.DirectPExecute("UPDATE account SET sessionkey = '%s', locale = '%s', failed_logins = 0, os = '%s', platform = '%s' WHERE username = '%s'", sessionKey.c_str(), safelocale.c_str(), os.c_str(), platform.c_str(), safelogin.c_str());
+            LoginDatabase.PExecute("INSERT INTO account_logons(accountId,ip,loginTime,loginSource) VALUES('%u','%s',NOW(),'%u')", accountId, address.c_str(), LOGIN_TYPE_REALMD);
+
+            // characters may have been created or deleted since the last login
+            sCharacterCountCache.Load(accountId);
+        },
+        [this]()
+        {
+            ///- Finish SRP6 and send the final result to the client
+            Sha1Hash sha;
+            srp.Finalize(sha);
 
-        ///- Set _status to authed!
-        _status = STATUS_AUTHED;
+            SendProof(sha);
+
+            ///- Set _status to authed!
+            _status = STATUS_AUTHED;
+        });
     }
     else
     {
@@ -632,40 +768,48 @@ bool AuthSocket::_HandleLogonProof()
         uint32 MaxWrongPassCount = sConfig.GetIntDefault("WrongPass.MaxCount", 0);
         if (MaxWrongPassCount > 0)
         {
-            // Increment number of failed logins by one and if it reaches the limit temporarily ban that account or IP
-            LoginDatabase.PExecute("UPDATE account SET failed_logins = failed_logins + 1 WHERE username = '%s'", _safelogin.c_str());
+            uint32 WrongPassBanTime = sConfig.GetIntDefault("WrongPass.BanTime", 600);
+            bool WrongPassBanType = sConfig.GetBoolDefault("WrongPass.BanType", false);
 
-            if (QueryResult* loginfail = LoginDatabase.PQuery("SELECT id, failed_logins FROM account WHERE username = '%s'", _safelogin.c_str()))
+            std::string const login = _login;
+            std::string const safelogin = _safelogin;
+            std::string const address = m_address;
+
+            // the answer is already sent, nothing waits for this
+            sTaskScheduler.Submit([MaxWrongPassCount, WrongPassBanTime, WrongPassBanType, login, safelogin, address]()
             {
-                Field* fields = loginfail->Fetch();
-                uint32 failed_logins = fields[1].GetUInt32();
+                // Increment number of failed logins by one and if it reaches the limit temporarily ban that account or IP
+                LoginDatabase.DirectPExecute("UPDATE account SET failed_logins = failed_logins + 1 WHERE username = '%s'", safelogin.c_str());
 
-                if (failed_logins >= MaxWrongPassCount)
+                if (QueryResult* loginfail = LoginDatabase.PQuery("SELECT id, failed_logins FROM account WHERE username = '%s'", safelogin.c_str()))
                 {
-                    uint32 WrongPassBanTime = sConfig.GetIntDefault("WrongPass.BanTime", 600);
-                    bool WrongPassBanType = sConfig.GetBoolDefault("WrongPass.BanType", false);
+                    Field* fields = loginfail->Fetch();
+                    uint32 failed_logins = fields[1].GetUInt32();
 
-                    if (WrongPassBanType)
+                    if (failed_logins >= MaxWrongPassCount)
                     {
-                        uint32 acc_id = fields[0].GetUInt32();
-                        LoginDatabase.PExecute("INSERT INTO account_banned(account_id, banned_at, expires_at, banned_by, reason, active)"
-                                               "VALUES ('%u',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban',1)",
-                                               acc_id, WrongPassBanTime);
-                        BASIC_LOG("[AuthChallenge] account %s got banned for '%u' seconds because it failed to authenticate '%u' times",
-                                  _login.c_str(), WrongPassBanTime, failed_logins);
-                    }
-                    else
-                    {
-                        std::string current_ip = m_address;
-                        LoginDatabase.escape_string(current_ip);
-                        LoginDatabase.PExecute("INSERT INTO ip_banned VALUES ('%s',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban')",
-                                               current_ip.c_str(), WrongPassBanTime);
-                        BASIC_LOG("[AuthChallenge] IP %s got banned for '%u' seconds because account %s failed to authenticate '%u' times",
-                                  current_ip.c_str(), WrongPassBanTime, _login.c_str(), failed_logins);
+                        if (WrongPassBanType)
+                        {
+                            uint32 acc_id = fields[0].GetUInt32();
+                            LoginDatabase.PExecute("INSERT INTO account_banned(account_id, banned_at, expires_at, banned_by, reason, active)"
+                                                   "VALUES ('%u',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban',1)",
+                                                   acc_id, WrongPassBanTime);
+                            BASIC_LOG("[AuthChallenge] account %s got banned for '%u' seconds because it failed to authenticate '%u' times",
+                                      login.c_str(), WrongPassBanTime, failed_logins);
+                        }
+                        else
+                        {
+                            std::string current_ip = address;
+                            LoginDatabase.escape_string(current_ip);
+                            LoginDatabase.PExecute("INSERT INTO ip_banned VALUES ('%s',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','MaNGOS realmd','Failed login autoban')",
+                                                   current_ip.c_str(), WrongPassBanTime);
+                            BASIC_LOG("[AuthChallenge] IP %s got banned for '%u' seconds because account %s failed to authenticate '%u' times",
+                                      current_ip.c_str(), WrongPassBanTime, login.c_str(), failed_logins);
+                        }
                     }
+                    delete loginfail;
                 }
-                delete loginfail;
-            }
+            });
         }
     }
     return true;
@@ -714,31 +858,46 @@ bool AuthSocket::_HandleReconnectChallenge()
     EndianConvert(ch->build);
     _build = ch->build;
 
-    QueryResult* result = LoginDatabase.PQuery("SELECT sessionkey FROM account WHERE username = '%s'", _safelogin.c_str());
+    std::shared_ptr<std::unique_ptr<QueryResult>> result = std::make_shared<std::unique_ptr<QueryResult>>();
+    std::string const safelogin = _safelogin;
 
-    // Stop if the account is not found
-    if (!result)
+    DatabaseRequest([result, safelogin]()
     {
-        sLog.outError("[ERROR] user %s tried to login and we cannot find his session key in the database.", _login.c_str());
-        Close();
-        return false;
-    }
+        result->reset(LoginDatabase.PQuery("SELECT id, gmlevel, sessionkey FROM account WHERE username = '%s'", safelogin.c_str()));
 
-    Field* fields = result->Fetch();
-    srp.SetStrongSessionKey(fields[0].GetString());
-    delete result;
+        // the client comes back from a world server, characters may have been created or deleted there
+        if (*result)
+            sCharacterCountCache.Load((**result)[0].GetUInt32());
+    },
+    [this, result]()
+    {
+        // Stop if the account is not found
+        if (!*result)
+        {
+            sLog.outError("[ERROR] user %s tried to login and we cannot find his session key in the database.", _login.c_str());
+            Close();
+            return;
+        }
 
-    ///- All good, await client's proof
-    _status = STATUS_RECON_PROOF;
+        Field* fields = (*result)->Fetch();
+        _accountId = fields[0].GetUInt32();
+        uint8 secLevel = fields[1].GetUInt8();
+        _accountSecurityLevel = secLevel <= SEC_ADMINISTRATOR ? AccountTypes(secLevel) : SEC_ADMINISTRATOR;
+        srp.SetStrongSessionKey(fields[2].GetString());
+
+        ///- All good, await client's proof
+        _status = STATUS_RECON_PROOF;
+
+        ///- Sending response
+        ByteBuffer pkt;
+        pkt << (uint8)  CMD_AUTH_RECONNECT_CHALLENGE;
+        pkt << (uint8)  0x00;
+        _reconnectProof.SetRand(16 * 8);
+        pkt.append(_reconnectProof.AsByteArray(16));        // 16 bytes random
+        pkt.append(VersionChallenge.data(), VersionChallenge.size());
+        Write((const char*)pkt.contents(), pkt.size());
+    });
 
-    ///- Sending response
-    ByteBuffer pkt;
-    pkt << (uint8)  CMD_AUTH_RECONNECT_CHALLENGE;
-    pkt << (uint8)  0x00;
-    _reconnectProof.SetRand(16 * 8);
-    pkt.append(_reconnectProof.AsByteArray(16));        // 16 bytes random
-    pkt.append(VersionChallenge.data(), VersionChallenge.size());
-    Write((const char*)pkt.contents(), pkt.size());
     return true;
 }
 
@@ -803,27 +962,30 @@ bool AuthSocket::_HandleRealmList()
 
     ReadSkip(5);
 
-    ///- Get the user id (else close the connection)
-    // No SQL injection (escaped user name)
-
-    QueryResult* result = LoginDatabase.PQuery("SELECT id, gmlevel FROM account WHERE username = '%s'", _safelogin.c_str());
-    if (!result)
+    ///- Account id and security level were loaded at authentication, character counts are usually cached since then
+    if (CharacterCountCache::CountsPtr counts = sCharacterCountCache.Find(_accountId))
     {
-        sLog.outError("[ERROR] user %s tried to login and we cannot find him in the database.", _login.c_str());
-        Close();
-        return false;
+        _SendRealmList(*counts);
+        return true;
     }
 
-    uint32 id = (*result)[0].GetUInt32();
-    uint8 accountSecurityLevel = (*result)[1].GetUInt8();
-    delete result;
+    std::shared_ptr<CharacterCountCache::CountsPtr> counts = std::make_shared<CharacterCountCache::CountsPtr>();
+    uint32 const accountId = _accountId;
 
+    DatabaseRequest([counts, accountId]() { *counts = sCharacterCountCache.Load(accountId); },
+                    [this, counts]() { _SendRealmList(**counts); });
+
+    return true;
+}
+
+void AuthSocket::_SendRealmList(CharacterCounts const& counts)
+{
     ///- Update realm list if need
     sRealmList.UpdateIfNeed();
 
     ///- Circle through realms in the RealmList and construct the return packet (including # of user characters in each realm)
     ByteBuffer pkt;
-    LoadRealmlist(pkt, id, accountSecurityLevel);
+    LoadRealmlist(pkt, counts, _accountSecurityLevel);
 
     ByteBuffer hdr;
     hdr << (uint8) CMD_REALM_LIST;
@@ -831,10 +993,9 @@ bool AuthSocket::_HandleRealmList()
     hdr.append(pkt);
 
     Write((const char*)hdr.contents(), hdr.size());
-    return true;
 }
 
-void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid, uint8 securityLevel)
+void AuthSocket::LoadRealmlist(ByteBuffer& pkt, CharacterCounts const& counts, uint8 securityLevel)
 {
     switch (_build)
     {
@@ -847,18 +1008,8 @@ void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid, uint8 securityLev
 
             for (const auto& i : sRealmList)
             {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                QueryResult* result = LoginDatabase.PQuery("SELECT numchars FROM realmcharacters WHERE realmid = '%d' AND acctid='%u'", i.second.m_ID, acctid);
-                if (result)
-                {
-                    Field* fields = result->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                    delete result;
-                }
-                else
-                    AmountOfCharacters = 0;
+                CharacterCounts::const_iterator count = counts.find(i.second.m_ID);
+                uint8 AmountOfCharacters = count != counts.end() ? count->second : 0;
 
                 bool ok_build = std::find(i.second.realmbuilds.begin(), i.second.realmbuilds.end(), _build) != i.second.realmbuilds.end();
 
@@ -915,18 +1066,8 @@ void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid, uint8 securityLev
 
             for (const auto& i : sRealmList)
             {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                QueryResult* result = LoginDatabase.PQuery("SELECT numchars FROM realmcharacters WHERE realmid = '%d' AND acctid='%u'", i.second.m_ID, acctid);
-                if (result)
-                {
-                    Field* fields = result->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                    delete result;
-                }
-                else
-                    AmountOfCharacters = 0;
+                CharacterCounts::const_iterator count = counts.find(i.second.m_ID);
+                uint8 AmountOfCharacters = count != counts.end() ? count->second : 0;
 
                 bool ok_build = std::find(i.second.realmbuilds.begin(), i.second.realmbuilds.end(), _build) != i.second.realmbuilds.end();
 
@@ -34,6 +34,13 @@
 #include <boost/asio.hpp>
 
 #include <functional>
+#include <map>
+#include <memory>
+
+class QueryResult;
+
+/// numchars of realmcharacters for one account, by realm id
+typedef std::map<uint32, uint8> CharacterCounts;
 
 #define HMAC_RES_SIZE 20
 
@@ -46,8 +53,11 @@ class AuthSocket : public MaNGOS::Socket
 
         bool Open() override;
 
+        /// Seconds the character counts shown in the realm list are reused, they are reloaded at every login
+        static void SetCharacterCountCacheTime(uint32 seconds);
+
         void SendProof(Sha1Hash sha);
-        void LoadRealmlist(ByteBuffer& pkt, uint32 acctid, uint8 accountSecurityLevel = 0);
+        void LoadRealmlist(ByteBuffer& pkt, CharacterCounts const& counts, uint8 accountSecurityLevel = 0);
         int32 generateToken(char const* b32key);
 
         uint8 getEligibleRealmCount(uint8 accountSecurityLevel);
@@ -79,6 +89,7 @@ class AuthSocket : public MaNGOS::Socket
         BigNumber _reconnectProof;
 
         eStatus _status;
+        uint32 _accountId;
 
         std::string _login;
         std::string _safelogin;
@@ -93,6 +104,21 @@ class AuthSocket : public MaNGOS::Socket
         boost::asio::deadline_timer m_timeoutTimer;
 
         virtual bool ProcessIncomingData() override;
+
+        struct LogonChallengeData
+        {
+            LogonChallengeData() : ipBanned(false) {}
+
+            bool ipBanned;
+            std::unique_ptr<QueryResult> account;
+            std::unique_ptr<QueryResult> accountBan;
+        };
+
+        /// Run query on a database worker, then continuation in the network thread of the socket unless it got closed meanwhile
+        void DatabaseRequest(std::function<void()> query, std::function<void()> continuation);
+
+        void _ContinueLogonChallenge(LogonChallengeData const& data);
+        void _SendRealmList(CharacterCounts const& counts);
 };
 #endif
 /// @}
@@ -32,6 +32,7 @@
 #include "revision_sql.h"
 #include "Util/Util.h"
 #include "Network/Listener.hpp"
+#include "Multithreading/TaskScheduler.h"
 
 #include <openssl/opensslv.h>
 #include <openssl/crypto.h>
@@ -234,6 +235,11 @@ int main(int argc, char* argv[])
     LoginDatabase.Execute("DELETE FROM ip_banned WHERE expires_at<=UNIX_TIMESTAMP() AND expires_at<>banned_at");
     LoginDatabase.CommitTransaction();
 
+    ///- Database work of the logon steps runs on these workers, so a slow query does not stall the network threads
+    sTaskScheduler.SetThreadHooks([]() { LoginDatabase.ThreadStart(); }, []() { LoginDatabase.ThreadEnd(); });
+    sTaskScheduler.Start(std::max(sConfig.GetIntDefault("LoginDatabaseConnections", 2), 1));
+    AuthSocket::SetCharacterCountCacheTime(sConfig.GetIntDefault("CharacterCountCacheTime", 60));
+
     // FIXME - more intelligent selection of thread count is needed here.  config option?
     MaNGOS::Listener<AuthSocket> listener(
             sConfig.GetStringDefault("BindIP", "0.0.0.0"),
@@ -313,7 +319,8 @@ int main(int argc, char* argv[])
 #endif
     }
 
-    ///- Wait for the delay thread to exit
+    ///- Finish the pending logon steps, then wait for the delay thread to exit
+    sTaskScheduler.Stop();
     LoginDatabase.HaltDelayThread();
 
     ///- Remove signal handling before leaving
@@ -353,9 +360,11 @@ bool StartDB()
         return false;
     }
 
-    sLog.outString("Login Database total connections: %i", 1 + 1);
+    int nConnections = sConfig.GetIntDefault("LoginDatabaseConnections", 2);
+
+    sLog.outString("Login Database total connections: %i", nConnections + 1);
 
-    if (!LoginDatabase.Initialize(dbstring.c_str()))
+    if (!LoginDatabase.Initialize(dbstring.c_str(), nConnections))
     {
         sLog.outError("Cannot connect to database");
         return false;
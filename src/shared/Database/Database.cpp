@@ -91,13 +91,32 @@ bool SqlConnection::ExecuteStmt(int nIndex, const SqlStmtParameters& id)
     return pStmt->execute();
 }
 
+QueryResult* SqlConnection::QueryStmt(int nIndex, const SqlStmtParameters& id)
+{
+    if (nIndex == -1)
+        return nullptr;
+
+    // get prepared statement object
+    SqlPreparedStatement* pStmt = GetStmt(nIndex);
+    if (!pStmt->isQuery())
+    {
+        sLog.outError("SQL ERROR: statement '%s' does not return a result set", m_db.GetStmtString(nIndex).c_str());
+        return nullptr;
+    }
+
+    // bind parameters
+    pStmt->bind(id);
+    // execute statement and fetch result
+    return pStmt->query();
+}
+
 //////////////////////////////////////////////////////////////////////////
 Database::~Database()
 {
     StopServer();
 }
 
-bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
+bool Database::Initialize(const char* infoString, int nConns /*= 1*/, int nAsyncConns /*= 1*/)
 {
     // Enable logging of SQL commands (usually only GM commands)
     // (See method: PExecuteLog)
@@ -110,6 +129,7 @@ bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
     }
 
     m_pingIntervallms = sConfig.GetIntDefault("MaxPingTime", 30) * (MINUTE * 1000);
+    m_asyncBatchSize = sConfig.GetIntDefault("DatabaseWriteBatchSize", 0);
 
     // create DB connections
 
@@ -134,10 +154,20 @@ bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
         m_pQueryConnections.push_back(pConn);
     }
 
-    // create and initialize connection for async requests
-    m_pAsyncConn = CreateConnection();
-    if (!m_pAsyncConn->Initialize(infoString))
-        return false;
+    // create and initialize connections for async requests
+    nAsyncConns = std::min(std::max(nAsyncConns, MIN_CONNECTION_POOL_SIZE), MAX_CONNECTION_POOL_SIZE);
+    for (int i = 0; i < nAsyncConns; ++i)
+    {
+        SqlConnection* pConn = CreateConnection();
+        if (!pConn->Initialize(infoString))
+        {
+            delete pConn;
+            return false;
+        }
+
+        m_asyncConnections.push_back(pConn);
+    }
+    m_pAsyncConn = m_asyncConnections.front();
 
     m_pResultQueue = new SqlResultQueue;
 
@@ -150,9 +180,11 @@ void Database::StopServer()
     HaltDelayThread();
 
     delete m_pResultQueue;
-    delete m_pAsyncConn;
+    for (auto& asyncConnection : m_asyncConnections)
+        delete asyncConnection;
 
     m_pResultQueue = nullptr;
+    m_asyncConnections.clear();
     m_pAsyncConn = nullptr;
 
     for (auto& m_pQueryConnection : m_pQueryConnections)
@@ -161,30 +193,51 @@ void Database::StopServer()
     m_pQueryConnections.clear();
 }
 
-SqlDelayThread* Database::CreateDelayThread()
+SqlDelayThread* Database::CreateDelayThread(SqlConnection* conn, bool pingDatabase)
 {
-    assert(m_pAsyncConn);
-    return new SqlDelayThread(this, m_pAsyncConn);
+    assert(m_delayQueue);
+    return new SqlDelayThread(m_delayQueue, this, conn, pingDatabase);
 }
 
 void Database::InitDelayThread()
 {
-    assert(!m_delayThread);
+    assert(m_delayThreads.empty());
+
+    m_delayQueue = new SqlDelayQueue(m_asyncBatchSize);
 
-    // New delay thread for delay execute
-    m_threadBody = CreateDelayThread();              // will deleted at m_delayThread delete
-    m_delayThread = new MaNGOS::Thread(m_threadBody);
+    // New delay threads for delay execute, one per async connection sharing one queue
+    for (size_t i = 0; i < m_asyncConnections.size(); ++i)
+    {
+        SqlDelayThread* threadBody = CreateDelayThread(m_asyncConnections[i], i == 0);  // will deleted at thread delete
+        m_threadBodies.push_back(threadBody);
+        m_delayThreads.push_back(new MaNGOS::Thread(threadBody));
+    }
 }
 
 void Database::HaltDelayThread()
 {
-    if (!m_threadBody || !m_delayThread) return;
+    if (!m_delayQueue) return;
+
+    m_delayQueue->Stop();                                   // Stop event
+    for (auto& delayThread : m_delayThreads)
+    {
+        delayThread->wait();                                // Wait for flush to DB
+        delete delayThread;                                 // This also deletes the thread body
+    }
+
+    m_delayThreads.clear();
+    m_threadBodies.clear();
+
+    delete m_delayQueue;
+    m_delayQueue = nullptr;
+}
+
+SqlDelayStats Database::GetAsyncStats(uint32 index) const
+{
+    if (index >= m_threadBodies.size())
+        return SqlDelayStats();
 
-    m_threadBody->Stop();                                   // Stop event
-    m_delayThread->wait();                                  // Wait for flush to DB
-    delete m_delayThread;                                   // This also deletes m_threadBody
-    m_delayThread = nullptr;
-    m_threadBody = nullptr;
+    return m_threadBodies[index]->GetStats();
 }
 
 void Database::ThreadStart()
@@ -229,8 +282,9 @@ void Database::Ping()
 {
     const char* sql = "SELECT 1";
 
+    for (auto& asyncConnection : m_asyncConnections)
     {
-        SqlConnection::Lock guard(m_pAsyncConn);
+        SqlConnection::Lock guard(asyncConnection);
         delete guard->Query(sql);
     }
 
@@ -339,7 +393,7 @@ bool Database::Execute(const char* sql)
             return DirectExecute(sql);
 
         // Simple sql statement
-        m_threadBody->Delay(new SqlPlainRequest(sql));
+        m_delayQueue->Delay(new SqlPlainRequest(sql));
     }
 
     return true;
@@ -385,7 +439,7 @@ bool Database::DirectPExecute(const char* format, ...)
     return DirectExecute(szQuery);
 }
 
-bool Database::BeginTransaction()
+bool Database::BeginTransaction(uint32 serialKey /*= 0*/)
 {
     if (!m_pAsyncConn)
         return false;
@@ -393,7 +447,7 @@ bool Database::BeginTransaction()
     MANGOS_ASSERT(!m_currentTransaction.get());   // if we will get a nested transaction request - we MUST fix code!!!
 
     if (!m_currentTransaction.get())
-        m_currentTransaction.reset(new SqlTransaction);
+        m_currentTransaction.reset(new SqlTransaction(serialKey));
 
     return m_currentTransaction.get() != nullptr;
 }
@@ -408,7 +462,8 @@ bool Database::CommitTransaction()
         return CommitTransactionDirect();
 
     // add SqlTransaction to the async queue
-    m_threadBody->Delay(m_currentTransaction.release());
+    SqlTransaction* pTrans = m_currentTransaction.release();
+    m_delayQueue->Delay(pTrans, pTrans->GetSerialKey());
     return true;
 }
 
@@ -563,7 +618,7 @@ bool Database::ExecuteStmt(const SqlStatementID& id, SqlStmtParameters* params)
             return DirectExecuteStmt(id, params);
 
         // Simple sql statement
-        m_threadBody->Delay(new SqlPreparedRequest(id.ID(), params));
+        m_delayQueue->Delay(new SqlPreparedRequest(id.ID(), params));
     }
 
     return true;
@@ -578,6 +633,15 @@ bool Database::DirectExecuteStmt(const SqlStatementID& id, SqlStmtParameters* pa
     return _guard->ExecuteStmt(id.ID(), *params);
 }
 
+QueryResult* Database::QueryStmt(const SqlStatementID& id, SqlStmtParameters* params)
+{
+    MANGOS_ASSERT(params);
+    std::unique_ptr<SqlStmtParameters> p(params);
+    // queries can use any connection of the pool
+    SqlConnection::Lock _guard(getQueryConnection());
+    return _guard->QueryStmt(id.ID(), *params);
+}
+
 SqlStatement Database::CreateStatement(SqlStatementID& index, const char* fmt)
 {
     int nId = -1;
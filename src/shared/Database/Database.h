@@ -61,8 +61,13 @@ class SqlConnection
         // can't rollback without transaction support
         virtual bool RollbackTransaction() { return true; }
 
+        // set when a failed statement made the server roll back the whole open transaction (deadlock, lock wait timeout)
+        bool IsTransactionLost() const { return m_transactionLost; }
+        void SetTransactionLost(bool lost) { m_transactionLost = lost; }
+
         // methods to work with prepared statements
         bool ExecuteStmt(int nIndex, const SqlStmtParameters& id);
+        QueryResult* QueryStmt(int nIndex, const SqlStmtParameters& id);
 
         // SqlConnection object lock
         class Lock
@@ -81,13 +86,14 @@ class SqlConnection
         Database& DB() const { return m_db; }
 
     protected:
-        SqlConnection(Database& db) : m_db(db) {}
+        SqlConnection(Database& db) : m_db(db), m_transactionLost(false) {}
 
         virtual SqlPreparedStatement* CreateStatement(const std::string& fmt);
         // allocate prepared statement and return statement ID
         SqlPreparedStatement* GetStmt(uint32 nIndex);
 
         Database& m_db;
+        bool m_transactionLost;
 
         // free prepared statements objects
         void FreePreparedStatements();
@@ -104,7 +110,8 @@ class Database
     public:
         virtual ~Database();
 
-        virtual bool Initialize(const char* infoString, int nConns = 1);
+        // nConns - connections for synchronous queries, nAsyncConns - connections executing async requests
+        virtual bool Initialize(const char* infoString, int nConns = 1, int nAsyncConns = 1);
         // start worker thread for async DB request execution
         virtual void InitDelayThread();
         // stop worker thread
@@ -183,7 +190,9 @@ class Database
         // Writes SQL commands to a LOG file (see mangosd.conf "LogSQL")
         bool PExecuteLog(const char* format, ...) ATTR_PRINTF(2, 3);
 
-        bool BeginTransaction();
+        // transactions with the same serialKey (character, account...) are executed in order,
+        // others may be executed in parallel on other async connections, 0 - ordered with everything
+        bool BeginTransaction(uint32 serialKey = 0);
         bool CommitTransaction();
         bool RollbackTransaction();
         // for sync transaction execution
@@ -212,6 +221,10 @@ class Database
         bool CheckRequiredField(char const* table_name, char const* required_name);
         uint32 GetPingIntervall() const { return m_pingIntervallms; }
 
+        // queue and timing counters of the async connections (delay threads)
+        uint32 GetAsyncConnectionCount() const { return uint32(m_threadBodies.size()); }
+        SqlDelayStats GetAsyncStats(uint32 index) const;
+
         // function to ping database connections
         void Ping();
 
@@ -223,8 +236,8 @@ class Database
     protected:
         Database() :
             m_nQueryConnPoolSize(1), m_pAsyncConn(nullptr), m_pResultQueue(nullptr),
-            m_threadBody(nullptr), m_delayThread(nullptr), m_allowAsyncTransactions(false),
-            m_iStmtIndex(-1), m_logSQL(false), m_pingIntervallms(0)
+            m_delayQueue(nullptr), m_allowAsyncTransactions(false),
+            m_iStmtIndex(-1), m_logSQL(false), m_pingIntervallms(0), m_asyncBatchSize(0)
         {
             m_nQueryCounter = -1;
         }
@@ -234,7 +247,7 @@ class Database
         // factory method to create SqlConnection objects
         virtual SqlConnection* CreateConnection() = 0;
         // factory method to create SqlDelayThread objects
-        virtual SqlDelayThread* CreateDelayThread();
+        virtual SqlDelayThread* CreateDelayThread(SqlConnection* conn, bool pingDatabase);
 
         // per-thread based storage for SqlTransaction object initialization - no locking is required
         boost::thread_specific_ptr<SqlTransaction> m_currentTransaction;
@@ -251,6 +264,7 @@ class Database
         // query function for prepared statements
         bool ExecuteStmt(const SqlStatementID& id, SqlStmtParameters* params);
         bool DirectExecuteStmt(const SqlStatementID& id, SqlStmtParameters* params);
+        QueryResult* QueryStmt(const SqlStatementID& id, SqlStmtParameters* params);
 
         // connection helper counters
         int m_nQueryConnPoolSize;                           // current size of query connection pool
@@ -260,12 +274,14 @@ class Database
         typedef std::vector< SqlConnection* > SqlConnectionContainer;
         SqlConnectionContainer m_pQueryConnections;
 
-        // only one single DB connection for transactions
+        // connections for async requests, the first one is also used for direct executes
+        SqlConnectionContainer m_asyncConnections;
         SqlConnection* m_pAsyncConn;
 
         SqlResultQueue*     m_pResultQueue;                 ///< Transaction queues from diff. threads
-        SqlDelayThread*     m_threadBody;                   ///< Pointer to delay sql executer (owned by m_delayThread)
-        MaNGOS::Thread*     m_delayThread;                  ///< Pointer to executer thread
+        SqlDelayQueue*      m_delayQueue;                   ///< Async requests, executed by the delay threads
+        std::vector<SqlDelayThread*> m_threadBodies;        ///< Delay sql executers (owned by m_delayThreads)
+        std::vector<MaNGOS::Thread*> m_delayThreads;        ///< Executer threads, one per async connection
 
         std::atomic<bool> m_allowAsyncTransactions;         ///< flag which specifies if async transactions are enabled
 
@@ -285,5 +301,6 @@ class Database
         bool m_logSQL;
         std::string m_logsDir;
         uint32 m_pingIntervallms;
+        uint32 m_asyncBatchSize;
 };
 #endif
@@ -25,8 +25,16 @@
 #include "DatabaseEnv.h"
 #include "Util/Timer.h"
 
+#include <mysqld_error.h>
+
 size_t DatabaseMysql::db_count = 0;
 
+// InnoDB rolls back the whole transaction on these, not only the failed statement
+static bool IsTransactionAbortError(unsigned int error)
+{
+    return error == ER_LOCK_DEADLOCK || error == ER_LOCK_WAIT_TIMEOUT;
+}
+
 void DatabaseMysql::ThreadStart()
 {
     mysql_thread_init();
@@ -252,6 +260,8 @@ bool MySQLConnection::Execute(const char* sql)
         {
             sLog.outErrorDb("SQL: %s", sql);
             sLog.outErrorDb("SQL ERROR: %s", mysql_error(mMysql));
+            if (IsTransactionAbortError(mysql_errno(mMysql)))
+                SetTransactionLost(true);
             return false;
         }
         DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL: %s", WorldTimer::getMSTimeDiff(_s, WorldTimer::getMSTime()), sql);
@@ -455,12 +465,42 @@ bool MySqlPreparedStatement::execute()
     {
         sLog.outError("SQL: cannot execute '%s'", m_szFmt.c_str());
         sLog.outError("SQL ERROR: %s", mysql_stmt_error(m_stmt));
+        if (IsTransactionAbortError(mysql_stmt_errno(m_stmt)))
+            m_pConn.SetTransactionLost(true);
         return false;
     }
 
     return true;
 }
 
+QueryResult* MySqlPreparedStatement::query()
+{
+    if (!isPrepared() || !isQuery())
+        return nullptr;
+
+    uint32 _s = WorldTimer::getMSTime();
+
+    if (mysql_stmt_execute(m_stmt))
+    {
+        sLog.outError("SQL: cannot execute '%s'", m_szFmt.c_str());
+        sLog.outError("SQL ERROR: %s", mysql_stmt_error(m_stmt));
+        return nullptr;
+    }
+
+    QueryResultMysqlStmt* queryResult = new QueryResultMysqlStmt(m_stmt, m_pResultMetadata);
+    DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL (binary): %s", WorldTimer::getMSTimeDiff(_s, WorldTimer::getMSTime()), m_szFmt.c_str());
+
+    // same as text queries: no result object for empty results, the first row is already fetched
+    if (!queryResult->IsValid() || !queryResult->GetRowCount())
+    {
+        delete queryResult;
+        return nullptr;
+    }
+
+    queryResult->NextRow();
+    return queryResult;
+}
+
 enum_field_types MySqlPreparedStatement::ToMySQLType(const SqlStmtFieldData& data, bool& bUnsigned)
 {
     bUnsigned = 0;
@@ -42,6 +42,8 @@ class MySqlPreparedStatement : public SqlPreparedStatement
 
         // execute DML statement
         virtual bool execute() override;
+        // execute query, result is fetched with the binary protocol
+        virtual QueryResult* query() override;
 
     protected:
         // bind parameters
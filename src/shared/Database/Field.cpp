@@ -29,3 +29,35 @@ time_t Field::GetTime() const
     ss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
     return std::mktime(&tm);
 }
+
+const char* Field::FormatBinary() const
+{
+    MANGOS_ASSERT(mText);
+
+    switch (mStorage)
+    {
+        case STORAGE_INT64:
+            snprintf(mText, BINARY_TEXT_SIZE, SI64FMTD, BinaryInt64());
+            break;
+        case STORAGE_UINT64:
+            snprintf(mText, BINARY_TEXT_SIZE, UI64FMTD, BinaryUInt64());
+            break;
+        default:
+        {
+            // shortest text reading back as the same value, like MySQL prints float/double columns
+            // float columns are converted to double by the client, so compare in float precision if possible
+            double const value = BinaryDouble();
+            bool const isFloat = static_cast<double>(static_cast<float>(value)) == value;
+            for (int precision = isFloat ? 6 : 15; precision <= 17; ++precision)
+            {
+                snprintf(mText, BINARY_TEXT_SIZE, "%.*g", precision, value);
+                double const parsed = strtod(mText, nullptr);
+                if (isFloat ? static_cast<float>(parsed) == static_cast<float>(value) : parsed == value)
+                    break;
+            }
+            break;
+        }
+    }
+
+    return mText;
+}
@@ -34,33 +34,105 @@ class Field
             DB_TYPE_BOOL    = 0x04
         };
 
-        Field() : mValue(nullptr), mType(DB_TYPE_UNKNOWN) {}
-        Field(const char* value, enum DataTypes type) : mValue(value), mType(type) {}
+        // how the current value is held: text returned by the DBMS or an already converted binary protocol value
+        enum StorageTypes
+        {
+            STORAGE_TEXT    = 0x00,
+            STORAGE_INT64   = 0x01,
+            STORAGE_UINT64  = 0x02,
+            STORAGE_DOUBLE  = 0x03
+        };
+
+        // size of the buffer a result provides for the text form of binary values
+        static const size_t BINARY_TEXT_SIZE = 32;
+
+        Field() : mValue(nullptr), mText(nullptr), mType(DB_TYPE_UNKNOWN), mStorage(STORAGE_TEXT) {}
+        Field(const char* value, enum DataTypes type) : mValue(value), mText(nullptr), mType(type), mStorage(STORAGE_TEXT) {}
 
         ~Field() {}
 
         enum DataTypes GetType() const { return mType; }
-        bool IsNULL() const { return mValue == nullptr; }
+        bool IsNULL() const { return mStorage == STORAGE_TEXT && mValue == nullptr; }
 
         const char* GetString() const
         {
+            if (mStorage != STORAGE_TEXT)
+                return FormatBinary();
+
             return mValue ? mValue : ""; // We need this null check as we do not always null check what we get back from the database everywhere
         }
         std::string GetCppString() const
         {
-            return mValue ? mValue : "";                    // std::string s = 0 have undefine result in C++
+            return GetString();                             // std::string s = 0 have undefine result in C++
+        }
+        float GetFloat() const
+        {
+            if (mStorage != STORAGE_TEXT)
+                return static_cast<float>(BinaryToDouble());
+
+            return mValue ? static_cast<float>(atof(mValue)) : 0.0f;
+        }
+        bool GetBool() const
+        {
+            if (mStorage != STORAGE_TEXT)
+                return mStorage == STORAGE_DOUBLE ? BinaryDouble() > 0.0 : BinaryToInt64() > 0;
+
+            return mValue ? atoi(mValue) > 0 : false;
+        }
+        double GetDouble() const
+        {
+            if (mStorage != STORAGE_TEXT)
+                return BinaryToDouble();
+
+            return mValue ? static_cast<double>(atof(mValue)) : 0.0f;
+        }
+        int32 GetInt32() const
+        {
+            if (mStorage != STORAGE_TEXT)
+                return static_cast<int32>(BinaryToInt64());
+
+            return mValue ? static_cast<int32>(atol(mValue)) : int32(0);
+        }
+        uint8 GetUInt8() const
+        {
+            if (mStorage != STORAGE_TEXT)
+                return static_cast<uint8>(BinaryToInt64());
+
+            return mValue ? static_cast<uint8>(atol(mValue)) : uint8(0);
+        }
+        int8 GetInt8() const
+        {
+            if (mStorage != STORAGE_TEXT)
+                return static_cast<int8>(BinaryToInt64());
+
+            return mValue ? static_cast<int8>(atol(mValue)) : int8(0);
+        }
+        uint16 GetUInt16() const
+        {
+            if (mStorage != STORAGE_TEXT)
+                return static_cast<uint16>(BinaryToInt64());
+
+            return mValue ? static_cast<uint16>(atol(mValue)) : uint16(0);
+        }
+        int16 GetInt16() const
+        {
+            if (mStorage != STORAGE_TEXT)
+                return static_cast<int16>(BinaryToInt64());
+
+            return mValue ? static_cast<int16>(atol(mValue)) : int16(0);
+        }
+        uint32 GetUInt32() const
+        {
+            if (mStorage != STORAGE_TEXT)
+                return static_cast<uint32>(BinaryToInt64());
+
+            return mValue ? static_cast<uint32>(atoll(mValue)) : uint32(0);
         }
-        float GetFloat() const { return mValue ? static_cast<float>(atof(mValue)) : 0.0f; }
-        bool GetBool() const { return mValue ? atoi(mValue) > 0 : false; }
-        double GetDouble() const { return mValue ? static_cast<double>(atof(mValue)) : 0.0f; }
-        int32 GetInt32() const { return mValue ? static_cast<int32>(atol(mValue)) : int32(0); }
-        uint8 GetUInt8() const { return mValue ? static_cast<uint8>(atol(mValue)) : uint8(0); }
-        int8 GetInt8() const { return mValue ? static_cast<int8>(atol(mValue)) : int8(0); }
-        uint16 GetUInt16() const { return mValue ? static_cast<uint16>(atol(mValue)) : uint16(0); }
-        int16 GetInt16() const { return mValue ? static_cast<int16>(atol(mValue)) : int16(0); }
-        uint32 GetUInt32() const { return mValue ? static_cast<uint32>(atoll(mValue)) : uint32(0); }
         uint64 GetUInt64() const
         {
+            if (mStorage != STORAGE_TEXT)
+                return mStorage == STORAGE_DOUBLE ? static_cast<uint64>(BinaryDouble()) : BinaryUInt64();
+
             uint64 value = 0;
             if (!mValue || sscanf(mValue, UI64FMTD, &value) == -1)
                 return 0;
@@ -72,6 +144,9 @@ class Field
 
         uint64 GetInt64() const
         {
+            if (mStorage != STORAGE_TEXT)
+                return BinaryToInt64();
+
             int64 value = 0;
             if (!mValue || sscanf(mValue, SI64FMTD, &value) == -1)
                 return 0;
@@ -82,13 +157,39 @@ class Field
         void SetType(enum DataTypes type) { mType = type; }
         // no need for memory allocations to store resultset field strings
         // all we need is to cache pointers returned by different DBMS APIs
-        void SetValue(const char* value) { mValue = value; }
+        void SetValue(const char* value) { mValue = value; mStorage = STORAGE_TEXT; }
+
+        // value already converted by the DBMS client (binary protocol), the 8 value bytes are owned by the result
+        // NULL values are set with SetValue(nullptr)
+        void SetBinaryValue(const uint64* value, enum StorageTypes storage) { mValue = reinterpret_cast<const char*>(value); mStorage = storage; }
+        // result owned buffer of BINARY_TEXT_SIZE chars, GetString() of a binary value is formatted into it
+        void SetTextBuffer(char* buffer) { mText = buffer; }
 
     private:
         Field(Field const&);
         Field& operator=(Field const&);
 
-        const char* mValue;
+        int64 BinaryInt64() const { int64 value; memcpy(&value, mValue, sizeof(value)); return value; }
+        uint64 BinaryUInt64() const { uint64 value; memcpy(&value, mValue, sizeof(value)); return value; }
+        double BinaryDouble() const { double value; memcpy(&value, mValue, sizeof(value)); return value; }
+
+        int64 BinaryToInt64() const { return mStorage == STORAGE_DOUBLE ? static_cast<int64>(BinaryDouble()) : BinaryInt64(); }
+        double BinaryToDouble() const
+        {
+            switch (mStorage)
+            {
+                case STORAGE_INT64:  return static_cast<double>(BinaryInt64());
+                case STORAGE_UINT64: return static_cast<double>(BinaryUInt64());
+                default:             return BinaryDouble();
+            }
+        }
+
+        // text form of a binary value, only built when requested, valid until the next row is fetched
+        const char* FormatBinary() const;
+
+        const char* mValue;                                 // text, or the binary value bytes for other storage types
+        char* mText;
         enum DataTypes mType;
+        enum StorageTypes mStorage;
 };
 #endif
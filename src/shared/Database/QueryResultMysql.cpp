@@ -21,6 +21,11 @@
 #include "DatabaseEnv.h"
 #include "Util/Errors.h"
 
+#include <type_traits>
+
+// my_bool in older and MariaDB client libraries, bool since MySQL 8.0
+typedef std::remove_pointer<decltype(MYSQL_BIND::is_null)>::type MySQLBool;
+
 QueryResultMysql::QueryResultMysql(MYSQL_RES* result, MYSQL_FIELD* fields, uint64 rowCount, uint32 fieldCount) :
     QueryResult(rowCount, fieldCount), mResult(result)
 {
@@ -96,4 +101,175 @@ enum Field::DataTypes QueryResultMysql::ConvertNativeType(enum_field_types mysql
             return Field::DB_TYPE_UNKNOWN;
     }
 }
+
+//////////////////////////////////////////////////////////////////////////
+QueryResultMysqlStmt::QueryResultMysqlStmt(MYSQL_STMT* stmt, MYSQL_RES* metadata) :
+    QueryResult(0, mysql_num_fields(metadata)), mNextRow(0), mValid(false)
+{
+    mCurrentRow = new Field[mFieldCount];
+
+    // text form of binary values, one slot per column so several fields of a row can be formatted at once
+    mText.resize(size_t(mFieldCount) * Field::BINARY_TEXT_SIZE);
+    for (uint32 i = 0; i < mFieldCount; ++i)
+        mCurrentRow[i].SetTextBuffer(&mText[size_t(i) * Field::BINARY_TEXT_SIZE]);
+
+    mValid = FetchAll(stmt, metadata);
+}
+
+QueryResultMysqlStmt::~QueryResultMysqlStmt()
+{
+    delete[] mCurrentRow;
+}
+
+bool QueryResultMysqlStmt::FetchAll(MYSQL_STMT* stmt, MYSQL_RES* metadata)
+{
+    MYSQL_FIELD* fields = mysql_fetch_fields(metadata);
+
+    mColumns.resize(mFieldCount);
+
+    // one row worth of client side buffers, values are moved to the column buffers after each fetch
+    std::vector<MYSQL_BIND> binds(mFieldCount);
+    std::vector<uint64> numbers(mFieldCount);
+    std::vector<std::vector<char>> strings(mFieldCount);
+    std::vector<unsigned long> lengths(mFieldCount);
+    std::unique_ptr<MySQLBool[]> nulls(new MySQLBool[mFieldCount]());     // no std::vector<bool> proxies here
+
+    memset(binds.data(), 0, sizeof(MYSQL_BIND) * mFieldCount);
+
+    for (uint32 i = 0; i < mFieldCount; ++i)
+    {
+        Column& column = mColumns[i];
+        MYSQL_BIND& bind = binds[i];
+
+        Field::DataTypes type = Field::DB_TYPE_STRING;
+        switch (fields[i].type)
+        {
+            case MYSQL_TYPE_TINY:
+            case MYSQL_TYPE_SHORT:
+            case MYSQL_TYPE_LONG:
+            case MYSQL_TYPE_INT24:
+            case MYSQL_TYPE_LONGLONG:
+            case MYSQL_TYPE_YEAR:
+                type = Field::DB_TYPE_INTEGER;
+                bind.buffer_type = MYSQL_TYPE_LONGLONG;
+                bind.is_unsigned = (fields[i].flags & UNSIGNED_FLAG) != 0;
+                bind.buffer = &numbers[i];
+                column.storage = bind.is_unsigned ? Field::STORAGE_UINT64 : Field::STORAGE_INT64;
+                break;
+            case MYSQL_TYPE_FLOAT:
+            case MYSQL_TYPE_DOUBLE:
+            case MYSQL_TYPE_DECIMAL:
+            case MYSQL_TYPE_NEWDECIMAL:
+                type = Field::DB_TYPE_FLOAT;
+                bind.buffer_type = MYSQL_TYPE_DOUBLE;
+                bind.buffer = &numbers[i];
+                column.storage = Field::STORAGE_DOUBLE;
+                break;
+            default:
+                // strings, blobs, enums and dates (converted to the same text the text protocol returns)
+                if (fields[i].type == MYSQL_TYPE_ENUM)
+                    type = Field::DB_TYPE_INTEGER;
+
+                strings[i].resize(64);
+                bind.buffer_type = MYSQL_TYPE_STRING;
+                bind.buffer = strings[i].data();
+                bind.buffer_length = strings[i].size();
+                column.storage = Field::STORAGE_TEXT;
+                break;
+        }
+
+        bind.length = &lengths[i];
+        bind.is_null = &nulls[i];
+
+        mCurrentRow[i].SetType(type);
+    }
+
+    if (mysql_stmt_bind_result(stmt, binds.data()))
+    {
+        sLog.outError("SQL ERROR: mysql_stmt_bind_result() failed");
+        sLog.outError("SQL ERROR: %s", mysql_stmt_error(stmt));
+        return false;
+    }
+
+    while (true)
+    {
+        int const status = mysql_stmt_fetch(stmt);
+        if (status == MYSQL_NO_DATA)
+            break;
+
+        if (status == 1)
+        {
+            sLog.outError("SQL ERROR: mysql_stmt_fetch() failed");
+            sLog.outError("SQL ERROR: %s", mysql_stmt_error(stmt));
+            mysql_stmt_free_result(stmt);
+            return false;
+        }
+
+        bool rebind = false;
+        for (uint32 i = 0; i < mFieldCount; ++i)
+        {
+            Column& column = mColumns[i];
+
+            if (column.storage != Field::STORAGE_TEXT)
+            {
+                column.values.push_back(numbers[i]);
+                column.nulls.push_back(nulls[i] != 0);
+                continue;
+            }
+
+            if (nulls[i])
+            {
+                column.values.push_back(0);
+                continue;
+            }
+
+            // value longer than the bound buffer, grow it and fetch this column again
+            if (status == MYSQL_DATA_TRUNCATED && lengths[i] >= strings[i].size())
+            {
+                strings[i].resize(lengths[i] + 1);
+                binds[i].buffer = strings[i].data();
+                binds[i].buffer_length = strings[i].size();
+                mysql_stmt_fetch_column(stmt, &binds[i], i, 0);
+                rebind = true;
+            }
+
+            column.values.push_back(mStrings.size() + 1);
+            mStrings.insert(mStrings.end(), strings[i].data(), strings[i].data() + lengths[i]);
+            mStrings.push_back('\0');
+        }
+
+        if (rebind)
+            mysql_stmt_bind_result(stmt, binds.data());
+
+        ++mRowCount;
+    }
+
+    mysql_stmt_free_result(stmt);
+    return true;
+}
+
+bool QueryResultMysqlStmt::NextRow()
+{
+    if (mNextRow >= mRowCount)
+        return false;
+
+    size_t const row = size_t(mNextRow++);
+    for (uint32 i = 0; i < mFieldCount; ++i)
+    {
+        Column const& column = mColumns[i];
+        Field& field = mCurrentRow[i];
+
+        if (column.storage == Field::STORAGE_TEXT)
+        {
+            uint64 const value = column.values[row];
+            field.SetValue(value ? &mStrings[value - 1] : nullptr);
+        }
+        else if (column.nulls[row])
+            field.SetValue(nullptr);
+        else
+            field.SetBinaryValue(&column.values[row], column.storage);
+    }
+
+    return true;
+}
 #endif
@@ -44,5 +44,39 @@ class QueryResultMysql : public QueryResult
 
         MYSQL_RES* mResult;
 };
+
+/**
+ * Result of a prepared statement fetched with the binary protocol.
+ *
+ * All rows are fetched at construction into typed column buffers (integers and floats converted by the client library,
+ * strings copied into one shared block), the Field array only views the current row, so no text is parsed per field.
+ */
+class QueryResultMysqlStmt : public QueryResult
+{
+    public:
+        QueryResultMysqlStmt(MYSQL_STMT* stmt, MYSQL_RES* metadata);
+
+        ~QueryResultMysqlStmt();
+
+        bool NextRow() override;
+
+        bool IsValid() const { return mValid; }
+
+    private:
+        struct Column
+        {
+            Field::StorageTypes storage;
+            std::vector<uint64> values;                     // raw value bits, for strings offset in mStrings + 1
+            std::vector<bool> nulls;                        // numeric columns only, strings use offset 0
+        };
+
+        bool FetchAll(MYSQL_STMT* stmt, MYSQL_RES* metadata);
+
+        std::vector<Column> mColumns;
+        std::vector<char> mStrings;
+        std::vector<char> mText;                            // Field::FormatBinary buffers
+        uint64 mNextRow;
+        bool mValid;
+};
 #endif
 #endif
@@ -18,8 +18,12 @@
 
 #include "SQLStorage.h"
 
+#include <cstdio>
+
 // -----------------------------------  SQLStorageBase  ---------------------------------------- //
 
+std::string SQLStorageBase::m_cacheDirectory;
+
 SQLStorageBase::SQLStorageBase() :
     m_tableName(nullptr),
     m_entry_field(nullptr),
@@ -30,7 +34,8 @@ SQLStorageBase::SQLStorageBase() :
     m_recordCount(0),
     m_maxEntry(0),
     m_recordSize(0),
-    m_data(nullptr)
+    m_data(nullptr),
+    m_tableChecksum(0)
 {}
 
 void SQLStorageBase::Initialize(const char* tableName, const char* entry_field, const char* src_format, const char* dst_format)
@@ -49,6 +54,9 @@ char* SQLStorageBase::createRecord(uint32 recordId)
     char* newRecord = &m_data[m_recordCount * m_recordSize];
     ++m_recordCount;
 
+    if (m_tableChecksum)
+        m_recordIds.push_back(recordId);
+
     JustCreatedRecord(recordId, newRecord);
     return newRecord;
 }
@@ -120,6 +128,291 @@ void SQLStorageBase::Free()
     m_recordCount = 0;
 }
 
+// Snapshot file layout:
+//   header
+//   uint32 record ids [recordCount]
+//   record block [recordCount * recordSize], string pointers replaced by (offset in string block + 1) or 0 for nullptr
+//   string block [stringBlockSize]
+struct SQLStorageCacheHeader
+{
+    uint32 magic;
+    uint32 version;
+    uint64 keyHash;
+    uint64 tableChecksum;
+    uint32 maxEntry;
+    uint32 recordCount;
+    uint32 recordSize;
+    uint32 padding;
+    uint64 stringBlockSize;
+};
+
+static const uint32 SQL_STORAGE_CACHE_MAGIC   = 0x534C5153;     // 'SQLS'
+static const uint32 SQL_STORAGE_CACHE_VERSION = 2;     // extra guard only, the key hash covers formats and record layout
+
+static uint64 HashString(uint64 hash, std::string const& str)
+{
+    // FNV-1a
+    for (char c : str)
+    {
+        hash ^= uint8(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+std::string SQLStorageBase::GetCacheFileName() const
+{
+    return m_cacheDirectory + "/" + m_tableName + ".sqlcache";
+}
+
+uint64 SQLStorageBase::GetCacheKeyHash(std::string const& loaderKey) const
+{
+    uint64 hash = 14695981039346656037ULL;
+    hash = HashString(hash, m_tableName);
+    hash = HashString(hash, m_src_format);
+    hash = HashString(hash, m_dst_format);
+    hash = HashString(hash, loaderKey);
+    hash = HashString(hash, m_tableSchema);
+    hash = HashString(hash, std::to_string(sizeof(char*)));
+    return hash;
+}
+
+bool SQLStorageBase::LoadFromCache(std::string const& loaderKey)
+{
+    m_tableChecksum = 0;
+    m_tableSchema.clear();
+    m_recordIds.clear();
+
+#ifdef DO_POSTGRESQL
+    return false;                                           // no cheap content checksum available
+#else
+    // the server computes the checksum, much cheaper than transferring and converting all rows
+    QueryResult* result = WorldDatabase.PQuery("CHECKSUM TABLE %s", m_tableName);
+    if (!result)
+        return false;
+
+    m_tableChecksum = (*result)[1].GetUInt64();
+    delete result;
+
+    if (!m_tableChecksum)
+        return false;
+
+    // a changed column type changes the converted values without changing the format strings
+    result = WorldDatabase.PQuery("SHOW COLUMNS FROM %s", m_tableName);
+    if (!result)
+    {
+        m_tableChecksum = 0;
+        return false;
+    }
+
+    do
+    {
+        Field* fields = result->Fetch();
+        m_tableSchema += fields[0].GetCppString() + " " + fields[1].GetCppString() + ";";
+    }
+    while (result->NextRow());
+    delete result;
+
+    FILE* file = fopen(GetCacheFileName().c_str(), "rb");
+    if (!file)
+        return false;
+
+    SQLStorageCacheHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        header.magic != SQL_STORAGE_CACHE_MAGIC || header.version != SQL_STORAGE_CACHE_VERSION ||
+        header.keyHash != GetCacheKeyHash(loaderKey) || header.tableChecksum != m_tableChecksum)
+    {
+        fclose(file);
+        return false;
+    }
+
+    std::vector<uint32> recordIds(header.recordCount);
+    std::vector<char> records(size_t(header.recordCount) * header.recordSize);
+    std::vector<char> strings(header.stringBlockSize);
+    if ((header.recordCount && fread(recordIds.data(), sizeof(uint32), recordIds.size(), file) != recordIds.size()) ||
+        (!records.empty() && fread(records.data(), 1, records.size(), file) != records.size()) ||
+        (!strings.empty() && fread(strings.data(), 1, strings.size(), file) != strings.size()))
+    {
+        fclose(file);
+        return false;
+    }
+    fclose(file);
+
+    prepareToLoad(header.maxEntry, header.recordCount, header.recordSize);
+    if (!records.empty())
+        memcpy(m_data, records.data(), records.size());
+
+    uint32 offset = 0;
+    for (uint32 x = 0; x < m_dstFieldCount; ++x)
+    {
+        switch (m_dst_format[x])
+        {
+            case FT_LOGIC:
+                offset += sizeof(bool);
+                break;
+            case FT_STRING:
+            {
+                // strings are owned per record (see Free), give each one its own allocation again
+                for (uint32 recordItr = 0; recordItr < header.recordCount; ++recordItr)
+                {
+                    char** field = (char**)(m_data + (recordItr * m_recordSize) + offset);
+                    uintptr_t stringOffset = 0;
+                    memcpy(&stringOffset, field, sizeof(uintptr_t));
+                    if (!stringOffset || stringOffset > strings.size())
+                    {
+                        *field = nullptr;
+                        continue;
+                    }
+
+                    char const* src = &strings[stringOffset - 1];
+                    size_t const length = strlen(src) + 1;
+                    *field = new char[length];
+                    memcpy(*field, src, length);
+                }
+                offset += sizeof(char*);
+                break;
+            }
+            case FT_NA:
+            case FT_INT:
+                offset += sizeof(uint32);
+                break;
+            case FT_BYTE:
+            case FT_NA_BYTE:
+                offset += sizeof(char);
+                break;
+            case FT_FLOAT:
+            case FT_NA_FLOAT:
+                offset += sizeof(float);
+                break;
+            case FT_NA_POINTER:
+                offset += sizeof(char*);
+                break;
+            case FT_64BITINT:
+                offset += sizeof(uint64);
+                break;
+            default:
+                assert(false && "unknown format character");
+                break;
+        }
+    }
+
+    // rebuild the lookup index, records are created in the same order as they were stored
+    m_tableChecksum = 0;
+    for (uint32 recordId : recordIds)
+        createRecord(recordId);
+
+    sLog.outString(">> Loaded %u records of `%s` from snapshot", m_recordCount, m_tableName);
+    return true;
+#endif
+}
+
+void SQLStorageBase::SaveToCache(std::string const& loaderKey)
+{
+    if (!m_tableChecksum || m_recordIds.size() != m_recordCount)
+    {
+        m_tableChecksum = 0;
+        m_recordIds.clear();
+        return;
+    }
+
+    std::vector<char> records(m_data, m_data + size_t(m_recordCount) * m_recordSize);
+    std::vector<char> strings;
+
+    uint32 offset = 0;
+    for (uint32 x = 0; x < m_dstFieldCount; ++x)
+    {
+        switch (m_dst_format[x])
+        {
+            case FT_LOGIC:
+                offset += sizeof(bool);
+                break;
+            case FT_STRING:
+            {
+                for (uint32 recordItr = 0; recordItr < m_recordCount; ++recordItr)
+                {
+                    char* field = &records[recordItr * m_recordSize + offset];
+                    char const* str = *(char const**)(m_data + (recordItr * m_recordSize) + offset);
+
+                    uintptr_t stringOffset = 0;
+                    if (str)
+                    {
+                        stringOffset = strings.size() + 1;
+                        strings.insert(strings.end(), str, str + strlen(str) + 1);
+                    }
+                    memcpy(field, &stringOffset, sizeof(uintptr_t));
+                }
+                offset += sizeof(char*);
+                break;
+            }
+            case FT_NA_POINTER:
+            {
+                // filled by code after load, never stored
+                for (uint32 recordItr = 0; recordItr < m_recordCount; ++recordItr)
+                    memset(&records[recordItr * m_recordSize + offset], 0, sizeof(char*));
+                offset += sizeof(char*);
+                break;
+            }
+            case FT_NA:
+            case FT_INT:
+                offset += sizeof(uint32);
+                break;
+            case FT_BYTE:
+            case FT_NA_BYTE:
+                offset += sizeof(char);
+                break;
+            case FT_FLOAT:
+            case FT_NA_FLOAT:
+                offset += sizeof(float);
+                break;
+            case FT_64BITINT:
+                offset += sizeof(uint64);
+                break;
+            default:
+                assert(false && "unknown format character");
+                break;
+        }
+    }
+
+    SQLStorageCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = SQL_STORAGE_CACHE_MAGIC;
+    header.version = SQL_STORAGE_CACHE_VERSION;
+    header.keyHash = GetCacheKeyHash(loaderKey);
+    header.tableChecksum = m_tableChecksum;
+    header.maxEntry = m_maxEntry;
+    header.recordCount = m_recordCount;
+    header.recordSize = m_recordSize;
+    header.stringBlockSize = strings.size();
+
+    // write to a temporary file first, a crash while writing must not leave a broken snapshot behind
+    std::string const fileName = GetCacheFileName();
+    std::string const tmpFileName = fileName + ".tmp";
+    bool ok = false;
+    if (FILE* file = fopen(tmpFileName.c_str(), "wb"))
+    {
+        ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+             (m_recordIds.empty() || fwrite(m_recordIds.data(), sizeof(uint32), m_recordIds.size(), file) == m_recordIds.size()) &&
+             (records.empty() || fwrite(records.data(), 1, records.size(), file) == records.size()) &&
+             (strings.empty() || fwrite(strings.data(), 1, strings.size(), file) == strings.size());
+        ok = (fclose(file) == 0) && ok;
+    }
+
+    if (ok)
+    {
+        remove(fileName.c_str());
+        ok = rename(tmpFileName.c_str(), fileName.c_str()) == 0;
+    }
+
+    if (!ok)
+    {
+        remove(tmpFileName.c_str());
+        sLog.outError("SQLStorage: can't write snapshot file %s", fileName.c_str());
+    }
+
+    m_tableChecksum = 0;
+    m_recordIds.clear();
+}
+
 // -----------------------------------  SQLStorage  -------------------------------------------- //
 
 void SQLStorage::EraseEntry(uint32 id)
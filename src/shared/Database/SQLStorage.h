@@ -64,6 +64,10 @@ class SQLStorageBase
         template<typename T>
         SQLSIterator<T> getDataEnd() const { return SQLSIterator<T>(m_data + m_recordCount * m_recordSize, m_recordSize); }
 
+        // Binary snapshots of loaded tables, used at next load when the table checksum did not change (empty directory - disabled)
+        static void SetCacheDirectory(std::string const& directory) { m_cacheDirectory = directory; }
+        static bool IsCacheEnabled() { return !m_cacheDirectory.empty(); }
+
     protected:
         SQLStorageBase();
         virtual ~SQLStorageBase() { Free(); }
@@ -78,9 +82,16 @@ class SQLStorageBase
         virtual void JustCreatedRecord(uint32 recordId, char* record) = 0;
         virtual void Free();
 
+        // loaderKey must describe everything besides the table content that the loaded values depend on
+        bool LoadFromCache(std::string const& loaderKey);
+        void SaveToCache(std::string const& loaderKey);
+
     private:
         char* createRecord(uint32 recordId);
 
+        std::string GetCacheFileName() const;
+        uint64 GetCacheKeyHash(std::string const& loaderKey) const;
+
         // Information about the table
         const char* m_tableName;
         const char* m_entry_field;
@@ -96,6 +107,13 @@ class SQLStorageBase
 
         // Data Storage
         char* m_data;
+
+        // Snapshot data
+        uint64 m_tableChecksum;
+        std::string m_tableSchema;                          // column names and types, part of the snapshot key
+        std::vector<uint32> m_recordIds;                    // record ids in creation order, only kept while a snapshot is pending
+
+        static std::string m_cacheDirectory;
 };
 
 class SQLStorage : public SQLStorageBase
@@ -269,6 +287,9 @@ class SQLStorageLoaderBase
         void convert_from_str(uint32 field_pos, char* src, D& dst);
         void convert_str_to_str(uint32 field_pos, char* src, char*& dst);
 
+        // loaders converting values with help of other data (script names...) have to describe that data here
+        std::string GetCacheKey() const { return std::string(); }
+
     private:
         template<class V>
         void storeValue(V value, StorageClass& store, char* p, uint32 x, uint32& offset);
@@ -20,14 +20,164 @@
 #include "Database/SqlOperations.h"
 #include "DatabaseEnv.h"
 
-SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn) : m_dbEngine(db), m_dbConnection(conn), m_running(true)
+// lookahead for operations that can overtake blocked ones, keeps Take() cheap with long queues
+#define SQL_DELAY_QUEUE_LOOKAHEAD 256
+
+template<typename T>
+static void StoreMax(std::atomic<T>& maxValue, T value)
+{
+    T current = maxValue;
+    while (value > current && !maxValue.compare_exchange_weak(current, value)) {}
+}
+
+bool SqlDelayQueue::Delay(SqlOperation* sql, uint32 serialKey)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_queue.push_back({ std::unique_ptr<SqlOperation>(sql), Clock::now(), serialKey });
+        StoreMax(m_maxQueueSize, uint32(m_queue.size()));
+    }
+
+    m_condition.notify_one();
+    return true;
+}
+
+size_t SqlDelayQueue::GetBatchEnd(size_t index) const
+{
+    size_t end = index + 1;
+    if (m_maxBatchSize <= 1 || !m_queue[index].operation->CanBatch())
+        return end;
+
+    uint32 const serialKey = m_queue[index].serialKey;
+    while (end < m_queue.size() && end - index < m_maxBatchSize &&
+            m_queue[end].serialKey == serialKey && m_queue[end].operation->CanBatch())
+        ++end;
+
+    return end;
+}
+
+bool SqlDelayQueue::Take(Batch& batch, Clock::time_point until)
+{
+    std::unique_lock<std::mutex> guard(m_mutex);
+
+    while (true)
+    {
+        if (!m_runningBarrier)
+        {
+            // keys of operations that have to wait, later operations with the same key have to wait too
+            std::vector<uint32> blockedKeys;
+
+            size_t const lookahead = std::min<size_t>(m_queue.size(), SQL_DELAY_QUEUE_LOOKAHEAD);
+            for (size_t i = 0; i < lookahead; ++i)
+            {
+                uint32 const serialKey = m_queue[i].serialKey;
+                if (!serialKey)
+                {
+                    // barrier, nothing queued after it may start before it
+                    if (i == 0 && m_runningKeys.empty())
+                    {
+                        size_t const end = GetBatchEnd(i);
+                        for (size_t j = i; j < end; ++j)
+                            batch.push_back(std::move(m_queue[j]));
+                        m_queue.erase(m_queue.begin() + i, m_queue.begin() + end);
+
+                        m_runningBarrier = true;
+                        return true;
+                    }
+                    break;
+                }
+
+                if (m_runningKeys.find(serialKey) != m_runningKeys.end() ||
+                        std::find(blockedKeys.begin(), blockedKeys.end(), serialKey) != blockedKeys.end())
+                {
+                    blockedKeys.push_back(serialKey);
+                    continue;
+                }
+
+                size_t const end = GetBatchEnd(i);
+                for (size_t j = i; j < end; ++j)
+                    batch.push_back(std::move(m_queue[j]));
+                m_queue.erase(m_queue.begin() + i, m_queue.begin() + end);
+
+                ++m_runningKeys[serialKey];
+                return true;
+            }
+        }
+
+        if (m_stopped && m_queue.empty())
+            return false;
+
+        if (m_condition.wait_until(guard, until) == std::cv_status::timeout)
+            return false;
+    }
+}
+
+void SqlDelayQueue::Done(Batch& batch)
+{
+    if (batch.empty())
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+
+        uint32 const serialKey = batch.front().serialKey;
+        if (!serialKey)
+            m_runningBarrier = false;
+        else
+        {
+            auto itr = m_runningKeys.find(serialKey);
+            if (--itr->second == 0)
+                m_runningKeys.erase(itr);
+        }
+    }
+
+    batch.clear();
+
+    // finished operations may unblock queued ones for any thread
+    m_condition.notify_all();
+}
+
+void SqlDelayQueue::Stop()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_stopped = true;
+    }
+
+    m_condition.notify_all();
+}
+
+bool SqlDelayQueue::IsFinished()
 {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_stopped && m_queue.empty();
 }
 
-SqlDelayThread::~SqlDelayThread()
+uint32 SqlDelayQueue::GetSize()
 {
-    // process all requests which might have been queued while thread was stopping
-    ProcessRequests();
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return uint32(m_queue.size());
+}
+
+//////////////////////////////////////////////////////////////////////////
+SqlDelayThread::SqlDelayThread(SqlDelayQueue* queue, Database* db, SqlConnection* conn, bool pingDatabase) :
+    m_queue(queue), m_dbEngine(db), m_dbConnection(conn), m_pingDatabase(pingDatabase),
+    m_executed(0), m_batches(0), m_totalWaitTime(0), m_maxWaitTime(0), m_totalExecTime(0), m_maxExecTime(0)
+{
+}
+
+SqlDelayStats SqlDelayThread::GetStats() const
+{
+    SqlDelayStats stats;
+    stats.queueSize = m_queue->GetSize();
+    stats.maxQueueSize = m_queue->GetMaxSize();
+    stats.executed = m_executed;
+    stats.batches = m_batches;
+    stats.totalWaitTime = m_totalWaitTime;
+    stats.maxWaitTime = m_maxWaitTime;
+    stats.totalExecTime = m_totalExecTime;
+    stats.maxExecTime = m_maxExecTime;
+    return stats;
 }
 
 void SqlDelayThread::run()
@@ -36,23 +186,27 @@ void SqlDelayThread::run()
     mysql_thread_init();
 #endif
 
-    const uint32 loopSleepms = 10;
-
-    const uint32 pingEveryLoop = m_dbEngine->GetPingIntervall() / loopSleepms;
+    // MaxPingTime = 0 disables the ping, the thread then only wakes up for new operations (or once a minute)
+    uint32 const pingIntervalMs = m_dbEngine->GetPingIntervall();
+    std::chrono::milliseconds const pingInterval(pingIntervalMs ? pingIntervalMs : MINUTE * IN_MILLISECONDS);
+    Clock::time_point nextPing = Clock::now() + pingInterval;
 
-    uint32 loopCounter = 0;
-    while (m_running)
+    // sleep until there is something to do instead of polling, the ping interval bounds the wait
+    // after stop the queue is emptied before exiting
+    SqlDelayQueue::Batch batch;
+    while (!m_queue->IsFinished())
     {
-        // if the running state gets turned off while sleeping
-        // empty the queue before exiting
-        MaNGOS::Thread::Sleep(loopSleepms);
-
-        ProcessRequests();
+        if (m_queue->Take(batch, nextPing))
+        {
+            Execute(batch);
+            m_queue->Done(batch);
+        }
 
-        if ((loopCounter++) >= pingEveryLoop)
+        if (Clock::now() >= nextPing)
         {
-            loopCounter = 0;
-            m_dbEngine->Ping();
+            if (pingIntervalMs && m_pingDatabase)
+                m_dbEngine->Ping();
+            nextPing = Clock::now() + pingInterval;
         }
     }
 
@@ -61,26 +215,74 @@ void SqlDelayThread::run()
 #endif
 }
 
-void SqlDelayThread::Stop()
+void SqlDelayThread::Execute(SqlDelayQueue::Batch& batch)
 {
-    m_running = false;
-}
+    if (batch.size() == 1)
+    {
+        Clock::time_point const start = Clock::now();
+        batch.front().operation->Execute(m_dbConnection);
+        UpdateStats(batch.front().queueTime, start, Clock::now());
+        return;
+    }
 
-void SqlDelayThread::ProcessRequests()
-{
-    std::queue<std::unique_ptr<SqlOperation>> sqlQueue;
+    // keep the connection for the whole batch, direct executes on the async connection must not end up inside it
+    SqlConnection::Lock guard(m_dbConnection);
+
+    // a statement failing with a plain error only rolls back itself, the others are still committed like without batching
+    m_dbConnection->SetTransactionLost(false);
+    m_dbConnection->BeginTransaction();
+
+    Clock::time_point start = Clock::now();
+    size_t executed = 0;
+    for (; executed < batch.size(); ++executed)
+    {
+        batch[executed].operation->Execute(m_dbConnection);
+
+        // a deadlock or lock wait timeout rolled back the statements executed before too
+        if (m_dbConnection->IsTransactionLost())
+            break;
 
-    // we need to move the contents of the queue to a local copy because executing these statements with the
-    // lock in place can result in a deadlock with the world thread which calls Database::ProcessResultQueue()
+        // the commit is accounted to the last operation of the batch
+        if (executed + 1 == batch.size())
+            m_dbConnection->CommitTransaction();
+
+        Clock::time_point const finish = Clock::now();
+        UpdateStats(batch[executed].queueTime, start, finish);
+        start = finish;
+    }
+
+    if (executed == batch.size())
     {
-        std::lock_guard<std::mutex> guard(m_queueMutex);
-        sqlQueue = std::move(m_sqlQueue);
+        ++m_batches;
+        return;
     }
 
-    while (!sqlQueue.empty())
+    // replay the whole batch one statement at a time, as it would have been executed without batching
+    sLog.outError("SqlDelayThread: batch of %u writes rolled back by the server, executing them one by one", uint32(batch.size()));
+    m_dbConnection->RollbackTransaction();
+    m_dbConnection->SetTransactionLost(false);
+
+    for (size_t i = 0; i < batch.size(); ++i)
     {
-        auto const s = std::move(sqlQueue.front());
-        sqlQueue.pop();
-        s->Execute(m_dbConnection);
+        batch[i].operation->Execute(m_dbConnection);
+        m_dbConnection->SetTransactionLost(false);
+
+        // the statements executed before the failure were already accounted
+        Clock::time_point const finish = Clock::now();
+        if (i >= executed)
+            UpdateStats(batch[i].queueTime, start, finish);
+        start = finish;
     }
 }
+
+void SqlDelayThread::UpdateStats(Clock::time_point queueTime, Clock::time_point start, Clock::time_point end)
+{
+    uint64 const waitTime = uint64(std::chrono::duration_cast<std::chrono::microseconds>(start - queueTime).count());
+    uint64 const execTime = uint64(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+
+    ++m_executed;
+    m_totalWaitTime += waitTime;
+    m_totalExecTime += execTime;
+    StoreMax(m_maxWaitTime, waitTime);
+    StoreMax(m_maxExecTime, execTime);
+}
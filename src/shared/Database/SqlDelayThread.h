@@ -23,39 +23,112 @@
 #include "SqlOperations.h"
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <unordered_map>
+#include <vector>
 
 class Database;
 class SqlOperation;
 class SqlConnection;
 
+// snapshot of the delay thread counters, times in microseconds
+struct SqlDelayStats
+{
+    uint32 queueSize;                                       ///< operations currently waiting (shared by all async connections)
+    uint32 maxQueueSize;                                    ///< highest queue size seen
+    uint64 executed;                                        ///< operations executed
+    uint64 batches;                                         ///< write batches committed as one transaction
+    uint64 totalWaitTime;                                   ///< sum of time operations spent in the queue
+    uint64 maxWaitTime;
+    uint64 totalExecTime;                                   ///< sum of execution time of operations
+    uint64 maxExecTime;
+};
+
+/**
+ * Async operations of one database, executed by one or more SqlDelayThread.
+ *
+ * Every operation has a serial key. Operations with the same key are executed in queue order, operations with
+ * different keys may run at the same time on different connections. Key 0 is a barrier: such an operation starts
+ * when everything queued before it is done and nothing queued after it starts before it is done.
+ * So code not using keys keeps the old strictly ordered behaviour.
+ */
+class SqlDelayQueue
+{
+    public:
+        typedef std::chrono::steady_clock Clock;
+
+        struct QueuedOperation
+        {
+            std::unique_ptr<SqlOperation> operation;
+            Clock::time_point queueTime;
+            uint32 serialKey;
+        };
+        typedef std::vector<QueuedOperation> Batch;
+
+        explicit SqlDelayQueue(uint32 maxBatchSize) : m_maxBatchSize(maxBatchSize), m_stopped(false), m_runningBarrier(false), m_maxQueueSize(0) {}
+
+        bool Delay(SqlOperation* sql, uint32 serialKey = 0);
+
+        // wait until operations can be executed (filled into batch, consecutive writes with the same key when batching is enabled)
+        // returns false at the time limit, or when the queue is stopped and empty
+        bool Take(Batch& batch, Clock::time_point until);
+        // operations taken with Take are executed, let conflicting ones run
+        void Done(Batch& batch);
+
+        void Stop();
+        bool IsFinished();                                  ///< stopped and nothing left to do
+
+        uint32 GetSize();
+        uint32 GetMaxSize() const { return m_maxQueueSize; }
+
+    private:
+        // operations after m_queue[index] that can be executed together with it
+        size_t GetBatchEnd(size_t index) const;
+
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::deque<QueuedOperation> m_queue;
+        uint32 m_maxBatchSize;                              ///< consecutive writes executed in one transaction, 0/1 - no batching
+        bool m_stopped;
+
+        // what is executed right now
+        std::unordered_map<uint32, uint32> m_runningKeys;
+        bool m_runningBarrier;
+
+        std::atomic<uint32> m_maxQueueSize;
+};
+
+/// Executes operations of a SqlDelayQueue on its own connection
 class SqlDelayThread : public MaNGOS::Runnable
 {
     private:
-        std::mutex m_queueMutex;
-        std::queue<std::unique_ptr<SqlOperation>> m_sqlQueue;   ///< Queue of SQL statements
-        Database* m_dbEngine;                                   ///< Pointer to used Database engine
-        SqlConnection* m_dbConnection;                          ///< Pointer to DB connection
-        std::atomic<bool> m_running;
+        typedef SqlDelayQueue::Clock Clock;
 
-        // process all enqueued requests
-        void ProcessRequests();
+        SqlDelayQueue* m_queue;                             ///< shared by all async connections of the database
+        Database* m_dbEngine;                               ///< Pointer to used Database engine
+        SqlConnection* m_dbConnection;                      ///< Pointer to DB connection
+        bool m_pingDatabase;                                ///< only one thread of a database keeps the connections alive
+
+        // counters for SqlDelayStats
+        std::atomic<uint64> m_executed;
+        std::atomic<uint64> m_batches;
+        std::atomic<uint64> m_totalWaitTime;
+        std::atomic<uint64> m_maxWaitTime;
+        std::atomic<uint64> m_totalExecTime;
+        std::atomic<uint64> m_maxExecTime;
+
+        void Execute(SqlDelayQueue::Batch& batch);
+        void UpdateStats(Clock::time_point queueTime, Clock::time_point start, Clock::time_point end);
 
     public:
-        SqlDelayThread(Database* db, SqlConnection* conn);
-        ~SqlDelayThread();
+        SqlDelayThread(SqlDelayQueue* queue, Database* db, SqlConnection* conn, bool pingDatabase);
 
-        ///< Put sql statement to delay queue
-        bool Delay(SqlOperation* sql)
-        {
-            std::lock_guard<std::mutex> guard(m_queueMutex);
-            m_sqlQueue.push(std::unique_ptr<SqlOperation>(sql));
-            return true;
-        }
+        SqlDelayStats GetStats() const;
 
-        virtual void Stop();                                ///< Stop event
         virtual void run();                                 ///< Main Thread loop
 };
 #endif                                                      //__SQLDELAYTHREAD_H
@@ -50,21 +50,43 @@ bool SqlTransaction::Execute(SqlConnection* conn)
 
     LOCK_DB_CONN(conn);
 
-    conn->BeginTransaction();
-
-    const int nItems = m_queue.size();
-    for (int i = 0; i < nItems; ++i)
+    // transactions of several async connections can deadlock each other, the server then rolls back one of them
+    // executing it again keeps the write (character saves...) as the single async connection never had such conflicts
+    for (uint32 attempt = 1; ; ++attempt)
     {
-        SqlOperation* pStmt = m_queue[i];
+        conn->SetTransactionLost(false);
+        conn->BeginTransaction();
 
-        if (!pStmt->Execute(conn))
+        bool failed = false;
+        const int nItems = m_queue.size();
+        for (int i = 0; i < nItems; ++i)
         {
-            conn->RollbackTransaction();
+            SqlOperation* pStmt = m_queue[i];
+
+            if (!pStmt->Execute(conn))
+            {
+                failed = true;
+                break;
+            }
+        }
+
+        if (!failed)
+            return conn->CommitTransaction();
+
+        conn->RollbackTransaction();
+
+        if (!conn->IsTransactionLost())
+            return false;
+
+        conn->SetTransactionLost(false);
+        if (attempt >= MAX_TRANSACTION_ATTEMPTS)
+        {
+            sLog.outError("SqlTransaction: rolled back by the server %u times, giving up", attempt);
             return false;
         }
-    }
 
-    return conn->CommitTransaction();
+        sLog.outError("SqlTransaction: rolled back by the server (deadlock or lock wait timeout), executing it again");
+    }
 }
 
 SqlPreparedRequest::SqlPreparedRequest(int nIndex, SqlStmtParameters* arg) : m_nIndex(nIndex), m_param(arg)
@@ -117,15 +139,15 @@ void SqlResultQueue::Add(MaNGOS::IQueryCallback* callback)
     m_queue.push(std::unique_ptr<MaNGOS::IQueryCallback>(callback));
 }
 
-bool SqlQueryHolder::Execute(MaNGOS::IQueryCallback* callback, SqlDelayThread* thread, SqlResultQueue* queue)
+bool SqlQueryHolder::Execute(MaNGOS::IQueryCallback* callback, SqlDelayQueue* delayQueue, SqlResultQueue* queue)
 {
-    if (!callback || !thread || !queue)
+    if (!callback || !delayQueue || !queue)
         return false;
 
     /// delay the execution of the queries, sync them with the delay thread
     /// which will in turn resync on execution (via the queue) and call back
     SqlQueryHolderEx* holderEx = new SqlQueryHolderEx(this, callback, queue);
-    thread->Delay(holderEx);
+    delayQueue->Delay(holderEx, m_serialKey);
     return true;
 }
 
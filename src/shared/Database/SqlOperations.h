@@ -31,7 +31,7 @@
 
 class Database;
 class SqlConnection;
-class SqlDelayThread;
+class SqlDelayQueue;
 class SqlStmtParameters;
 
 class SqlOperation
@@ -39,6 +39,8 @@ class SqlOperation
     public:
         virtual void OnRemove() { delete this; }
         virtual bool Execute(SqlConnection* conn) = 0;
+        // single write without result, may be executed together with other writes inside one transaction
+        virtual bool CanBatch() const { return false; }
         virtual ~SqlOperation() {}
 };
 
@@ -52,18 +54,24 @@ class SqlPlainRequest : public SqlOperation
         SqlPlainRequest(const char* sql) : m_sql(mangos_strdup(sql)) {}
         ~SqlPlainRequest() { char* tofree = const_cast<char*>(m_sql); delete[] tofree; }
         bool Execute(SqlConnection* conn) override;
+        bool CanBatch() const override { return true; }
 };
 
 class SqlTransaction : public SqlOperation
 {
     private:
         std::vector<SqlOperation* > m_queue;
+        uint32 m_serialKey;
+
+        // executions of a transaction rolled back by the server (deadlock, lock wait timeout)
+        static const uint32 MAX_TRANSACTION_ATTEMPTS = 3;
 
     public:
-        SqlTransaction() {}
+        explicit SqlTransaction(uint32 serialKey = 0) : m_serialKey(serialKey) {}
         ~SqlTransaction();
 
         void DelayExecute(SqlOperation* sql) { m_queue.push_back(sql); }
+        uint32 GetSerialKey() const { return m_serialKey; }
 
         bool Execute(SqlConnection* conn) override;
 };
@@ -75,6 +83,7 @@ class SqlPreparedRequest : public SqlOperation
         ~SqlPreparedRequest();
 
         bool Execute(SqlConnection* conn) override;
+        bool CanBatch() const override { return true; }
 
     private:
         const int m_nIndex;
@@ -122,15 +131,18 @@ class SqlQueryHolder
     private:
         typedef std::pair<const char*, QueryResult*> SqlResultPair;
         std::vector<SqlResultPair> m_queries;
+        uint32 m_serialKey;
     public:
-        SqlQueryHolder() {}
+        SqlQueryHolder() : m_serialKey(0) {}
         virtual ~SqlQueryHolder();
         bool SetQuery(size_t index, const char* sql);
         bool SetPQuery(size_t index, const char* format, ...) ATTR_PRINTF(3, 4);
         void SetSize(size_t size);
         QueryResult* GetResult(size_t index);
         void SetResult(size_t index, QueryResult* result);
-        bool Execute(MaNGOS::IQueryCallback* callback, SqlDelayThread* thread, SqlResultQueue* queue);
+        // queries are ordered with async transactions using the same key, see Database::BeginTransaction
+        void SetSerialKey(uint32 serialKey) { m_serialKey = serialKey; }
+        bool Execute(MaNGOS::IQueryCallback* callback, SqlDelayQueue* delayQueue, SqlResultQueue* queue);
 };
 
 class SqlQueryHolderEx : public SqlOperation
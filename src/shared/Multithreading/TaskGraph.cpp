@@ -0,0 +1,134 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Multithreading/TaskGraph.h"
+#include "Log/Log.h"
+#include "Util/Errors.h"
+
+using namespace MaNGOS;
+
+void TaskGraph::AddStage(std::string const& name, std::vector<std::string> const& dependencies, Task task)
+{
+    Stage stage;
+    stage.name = name;
+    stage.task = std::move(task);
+    stage.remainingDependencies = 0;
+    stage.startTime = 0;
+    stage.duration = 0;
+
+    for (auto const& dependency : dependencies)
+    {
+        size_t index = 0;
+        while (index < m_stages.size() && m_stages[index].name != dependency)
+            ++index;
+
+        // dependencies have to be declared first
+        MANGOS_ASSERT(index < m_stages.size());
+
+        stage.dependencies.push_back(index);
+        m_stages[index].dependents.push_back(m_stages.size());
+        ++stage.remainingDependencies;
+    }
+
+    m_stages.push_back(std::move(stage));
+}
+
+void TaskGraph::Run(TaskScheduler& scheduler)
+{
+    Clock::time_point const graphStart = Clock::now();
+
+    {
+        TaskGroup group(scheduler);
+        for (size_t i = 0; i < m_stages.size(); ++i)
+            if (!m_stages[i].remainingDependencies)
+                RunStage(i, group, graphStart);
+
+        group.Wait();
+    }
+
+    m_totalTime = uint32(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - graphStart).count());
+}
+
+void TaskGraph::RunStage(size_t index, TaskGroup& group, Clock::time_point graphStart)
+{
+    group.Run([this, index, &group, graphStart]()
+    {
+        Stage& stage = m_stages[index];
+
+        Clock::time_point const start = Clock::now();
+        stage.task();
+        Clock::time_point const end = Clock::now();
+
+        stage.startTime = uint32(std::chrono::duration_cast<std::chrono::milliseconds>(start - graphStart).count());
+        stage.duration = uint32(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count());
+
+        // start every dependent stage that was only waiting for this one
+        std::vector<size_t> ready;
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            for (size_t dependent : stage.dependents)
+                if (--m_stages[dependent].remainingDependencies == 0)
+                    ready.push_back(dependent);
+        }
+
+        for (size_t dependent : ready)
+            RunStage(dependent, group, graphStart);
+    });
+}
+
+void TaskGraph::LogTimings() const
+{
+    if (m_stages.empty())
+        return;
+
+    // longest chain ending at each stage, stages are stored in a valid topological order
+    std::vector<uint32> pathTime(m_stages.size(), 0);
+    std::vector<size_t> pathPrev(m_stages.size(), m_stages.size());
+    uint32 stagesTime = 0;
+    size_t last = 0;
+
+    for (size_t i = 0; i < m_stages.size(); ++i)
+    {
+        Stage const& stage = m_stages[i];
+        for (size_t dependency : stage.dependencies)
+        {
+            if (pathTime[dependency] >= pathTime[i])
+            {
+                pathTime[i] = pathTime[dependency];
+                pathPrev[i] = dependency;
+            }
+        }
+
+        pathTime[i] += stage.duration;
+        stagesTime += stage.duration;
+
+        if (pathTime[i] > pathTime[last])
+            last = i;
+    }
+
+    sLog.outString(">> %s: %u stages done in %u ms (%u ms if run one after another)", m_name.c_str(), uint32(m_stages.size()), m_totalTime, stagesTime);
+
+    for (auto const& stage : m_stages)
+        sLog.outDetail("   %-40s started at %6u ms, took %6u ms", stage.name.c_str(), stage.startTime, stage.duration);
+
+    std::string criticalPath;
+    for (size_t i = last; i < m_stages.size(); i = pathPrev[i])
+        criticalPath = m_stages[i].name + (criticalPath.empty() ? "" : " -> ") + criticalPath;
+
+    sLog.outString(">> %s critical path (%u ms): %s", m_name.c_str(), pathTime[last], criticalPath.c_str());
+}
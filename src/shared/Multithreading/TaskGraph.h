@@ -0,0 +1,76 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_TASKGRAPH_H
+#define MANGOS_TASKGRAPH_H
+
+#include "Common.h"
+#include "Multithreading/TaskScheduler.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace MaNGOS
+{
+    /**
+     * Set of named stages with declared dependencies, executed on a TaskScheduler.
+     * A stage starts as soon as all stages it depends on are finished, independent stages run concurrently.
+     * Dependencies must be added before the stages using them, so the graph can't contain cycles.
+     *
+     * After Run() the per stage timings and the critical path (longest chain of dependent stages,
+     * the lower bound of the graph run time) can be written to the log with LogTimings().
+     */
+    class TaskGraph
+    {
+        public:
+            explicit TaskGraph(std::string const& name) : m_name(name), m_totalTime(0) {}
+
+            TaskGraph(const TaskGraph&) = delete;
+            TaskGraph& operator=(const TaskGraph&) = delete;
+
+            void AddStage(std::string const& name, std::vector<std::string> const& dependencies, Task task);
+
+            void Run(TaskScheduler& scheduler);
+            void LogTimings() const;
+
+        private:
+            typedef std::chrono::steady_clock Clock;
+
+            struct Stage
+            {
+                std::string name;
+                Task task;
+                std::vector<size_t> dependencies;
+                std::vector<size_t> dependents;
+
+                uint32 remainingDependencies;
+                uint32 startTime;                           // ms since graph start
+                uint32 duration;                            // ms
+            };
+
+            void RunStage(size_t index, TaskGroup& group, Clock::time_point graphStart);
+
+            std::string m_name;
+            std::vector<Stage> m_stages;
+            uint32 m_totalTime;
+            std::mutex m_lock;
+    };
+}
+
+#endif
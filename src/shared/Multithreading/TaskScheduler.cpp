@@ -0,0 +1,335 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Multithreading/TaskScheduler.h"
+
+#include <algorithm>
+
+INSTANTIATE_SINGLETON_1(MaNGOS::TaskScheduler);
+
+using namespace MaNGOS;
+
+namespace
+{
+    // index of the worker owning the current thread, -1 for threads not belonging to the scheduler
+    thread_local int32 t_workerIndex = -1;
+    thread_local TaskScheduler const* t_workerScheduler = nullptr;
+}
+
+void TaskScheduler::Start(uint32 numThreads)
+{
+    if (IsRunning())
+        return;
+
+    if (!numThreads)
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    m_stop = false;
+
+    for (uint32 i = 0; i < numThreads; ++i)
+        m_workerQueues.push_back(std::make_unique<WorkerQueue>());
+
+    for (uint32 i = 0; i < numThreads; ++i)
+        m_threads.push_back(std::thread(&TaskScheduler::WorkerThread, this, i));
+}
+
+void TaskScheduler::Stop()
+{
+    if (!IsRunning())
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(m_sleepLock);
+        m_stop = true;
+    }
+    m_sleepCondition.notify_all();
+
+    for (auto& thread : m_threads)
+        thread.join();
+
+    m_threads.clear();
+
+    // nobody is left to execute remaining tasks
+    Task task;
+    while (PopGlobal(task) || Steal(0, task))
+        task();
+
+    m_workerQueues.clear();
+}
+
+void TaskScheduler::Submit(Task task)
+{
+    if (!IsRunning())
+    {
+        task();
+        return;
+    }
+
+    if (t_workerScheduler == this)
+    {
+        WorkerQueue& queue = *m_workerQueues[t_workerIndex];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        queue.tasks.push_back(std::move(task));
+    }
+    else
+    {
+        std::lock_guard<std::mutex> guard(m_globalLock);
+        m_globalQueue.push_back(std::move(task));
+    }
+
+    ++m_queuedTasks;
+
+    // take the sleep lock so a worker that just checked the counter can't miss the notification
+    {
+        std::lock_guard<std::mutex> guard(m_sleepLock);
+    }
+    m_sleepCondition.notify_one();
+}
+
+bool TaskScheduler::RunPendingTask()
+{
+    Task task;
+    if (!PopTask(task))
+        return false;
+
+    task();
+    return true;
+}
+
+void TaskScheduler::ParallelFor(size_t begin, size_t end, size_t grain, std::function<void(size_t)> const& func)
+{
+    if (begin >= end)
+        return;
+
+    size_t const count = end - begin;
+    if (!grain)
+        grain = std::max<size_t>(1, count / (std::max(GetThreadCount(), 1u) * 4));
+
+    if (!IsRunning() || count <= grain)
+    {
+        for (size_t i = begin; i < end; ++i)
+            func(i);
+        return;
+    }
+
+    TaskGroup group(*this);
+    for (size_t chunk = begin; chunk < end; chunk += grain)
+    {
+        size_t const chunkEnd = std::min(chunk + grain, end);
+        group.Run([chunk, chunkEnd, &func]()
+        {
+            for (size_t i = chunk; i < chunkEnd; ++i)
+                func(i);
+        });
+    }
+    group.Wait();
+}
+
+void TaskScheduler::WorkerThread(uint32 index)
+{
+    t_workerIndex = int32(index);
+    t_workerScheduler = this;
+
+    if (m_threadStart)
+        m_threadStart();
+
+    while (true)
+    {
+        Task task;
+        if (PopTask(task))
+        {
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> guard(m_sleepLock);
+        while (!m_stop && m_queuedTasks == 0)
+            m_sleepCondition.wait(guard);
+
+        if (m_stop)
+            break;
+    }
+
+    if (m_threadStop)
+        m_threadStop();
+}
+
+bool TaskScheduler::PopTask(Task& task)
+{
+    if (m_queuedTasks == 0)
+        return false;
+
+    if (t_workerScheduler == this && PopLocal(uint32(t_workerIndex), task))
+        return true;
+
+    if (PopGlobal(task))
+        return true;
+
+    return Steal(t_workerScheduler == this ? uint32(t_workerIndex) : 0, task);
+}
+
+bool TaskScheduler::PopLocal(uint32 index, Task& task)
+{
+    WorkerQueue& queue = *m_workerQueues[index];
+    std::lock_guard<std::mutex> guard(queue.lock);
+    if (queue.tasks.empty())
+        return false;
+
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    --m_queuedTasks;
+    return true;
+}
+
+bool TaskScheduler::PopGlobal(Task& task)
+{
+    std::lock_guard<std::mutex> guard(m_globalLock);
+    if (m_globalQueue.empty())
+        return false;
+
+    task = std::move(m_globalQueue.front());
+    m_globalQueue.pop_front();
+    --m_queuedTasks;
+    return true;
+}
+
+bool TaskScheduler::Steal(uint32 thief, Task& task)
+{
+    uint32 const count = uint32(m_workerQueues.size());
+    for (uint32 i = 1; i <= count; ++i)
+    {
+        WorkerQueue& queue = *m_workerQueues[(thief + i) % count];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        if (queue.tasks.empty())
+            continue;
+
+        // steal the oldest task, the owner keeps working on the most recent ones
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        --m_queuedTasks;
+        return true;
+    }
+
+    return false;
+}
+
+TaskGroup::TaskGroup(TaskScheduler& scheduler) : m_state(std::make_shared<State>(scheduler))
+{
+}
+
+TaskGroup::TaskGroup() : TaskGroup(sTaskScheduler)
+{
+}
+
+void TaskGroup::Run(Task task)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_state->lock);
+        ++m_state->pending;
+    }
+
+    Dispatch(m_state, std::move(task));
+}
+
+void TaskGroup::Then(Task continuation)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_state->lock);
+        if (m_state->pending)
+        {
+            m_state->continuations.push_back(std::move(continuation));
+            return;
+        }
+
+        ++m_state->pending;
+    }
+
+    // group already finished, continuation can start right away
+    Dispatch(m_state, std::move(continuation));
+}
+
+void TaskGroup::Wait()
+{
+    std::unique_lock<std::mutex> guard(m_state->lock);
+    while (m_state->pending)
+    {
+        // help with tasks of this group only, unrelated long tasks would delay the waiter
+        // this also prevents a deadlock when the waiting thread is a worker itself
+        if (!m_state->tasks.empty())
+        {
+            Task task = std::move(m_state->tasks.front());
+            m_state->tasks.pop_front();
+
+            guard.unlock();
+            RunTask(m_state, task);
+            guard.lock();
+            continue;
+        }
+
+        m_state->condition.wait(guard);
+    }
+}
+
+void TaskGroup::Dispatch(std::shared_ptr<State> const& state, Task task)
+{
+    {
+        std::lock_guard<std::mutex> guard(state->lock);
+        state->tasks.push_back(std::move(task));
+    }
+    // a waiting thread can take it too
+    state->condition.notify_all();
+
+    // one scheduler entry per task, it finds nothing left when the waiting thread was faster
+    state->scheduler.Submit([state]()
+    {
+        Task task;
+        {
+            std::lock_guard<std::mutex> guard(state->lock);
+            if (state->tasks.empty())
+                return;
+
+            task = std::move(state->tasks.front());
+            state->tasks.pop_front();
+        }
+
+        RunTask(state, task);
+    });
+}
+
+void TaskGroup::RunTask(std::shared_ptr<State> const& state, Task& task)
+{
+    task();
+
+    std::vector<Task> continuations;
+    {
+        std::lock_guard<std::mutex> guard(state->lock);
+
+        // last task of the group, continuations are counted before this one so Wait() can't return in between
+        if (state->pending == 1 && !state->continuations.empty())
+        {
+            std::swap(continuations, state->continuations);
+            state->pending += uint32(continuations.size());
+        }
+
+        if (--state->pending == 0)
+            state->condition.notify_all();
+    }
+
+    for (auto& continuation : continuations)
+        Dispatch(state, std::move(continuation));
+}
@@ -0,0 +1,148 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_TASKSCHEDULER_H
+#define MANGOS_TASKSCHEDULER_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MaNGOS
+{
+    typedef std::function<void()> Task;
+
+    /**
+     * Work-stealing job system shared by every subsystem that has independent work to spread over the cores
+     * (map updates, grid loading, startup loaders...).
+     *
+     * Each worker owns a deque: tasks submitted from a worker go to the back of its own deque and are popped
+     * from there (LIFO, cache friendly), idle workers steal from the front of the other deques.
+     * Tasks submitted from any other thread go to a shared injection queue.
+     */
+    class TaskScheduler
+    {
+        public:
+            TaskScheduler() : m_queuedTasks(0), m_stop(false) {}
+            ~TaskScheduler() { Stop(); }
+
+            TaskScheduler(const TaskScheduler&) = delete;
+            TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+            // called in every worker thread when it starts and before it exits (per thread library data...), set before Start()
+            void SetThreadHooks(Task onStart, Task onStop) { m_threadStart = std::move(onStart); m_threadStop = std::move(onStop); }
+
+            // numThreads = 0 use one worker per hardware thread
+            void Start(uint32 numThreads);
+            void Stop();
+
+            bool IsRunning() const { return !m_threads.empty(); }
+            uint32 GetThreadCount() const { return uint32(m_threads.size()); }
+
+            // fire and forget, executed in calling thread when scheduler is not running
+            void Submit(Task task);
+
+            // execute one queued task in the calling thread, returns false when there was nothing to do
+            bool RunPendingTask();
+
+            // call func(i) for every i in [begin, end), split in chunks of grain indexes (0 - automatic)
+            void ParallelFor(size_t begin, size_t end, size_t grain, std::function<void(size_t)> const& func);
+
+        private:
+            struct WorkerQueue
+            {
+                std::mutex lock;
+                std::deque<Task> tasks;
+            };
+
+            void WorkerThread(uint32 index);
+            bool PopTask(Task& task);
+
+            bool PopLocal(uint32 index, Task& task);
+            bool PopGlobal(Task& task);
+            bool Steal(uint32 thief, Task& task);
+
+            std::vector<std::unique_ptr<WorkerQueue>> m_workerQueues;
+            std::vector<std::thread> m_threads;
+
+            std::mutex m_globalLock;
+            std::deque<Task> m_globalQueue;
+
+            std::mutex m_sleepLock;
+            std::condition_variable m_sleepCondition;
+
+            std::atomic<uint32> m_queuedTasks;
+            std::atomic<bool> m_stop;
+
+            Task m_threadStart;
+            Task m_threadStop;
+    };
+
+    /**
+     * Set of tasks that can be waited for as a whole.
+     * Continuations added with Then() are submitted when every task of the group is done,
+     * Wait() returns once tasks and continuations are finished. The waiting thread helps executing
+     * tasks of this group that no worker started yet, then sleeps until the last one is done.
+     */
+    class TaskGroup
+    {
+        public:
+            explicit TaskGroup(TaskScheduler& scheduler);
+            TaskGroup();
+            ~TaskGroup() { Wait(); }
+
+            TaskGroup(const TaskGroup&) = delete;
+            TaskGroup& operator=(const TaskGroup&) = delete;
+
+            void Run(Task task);
+            void Then(Task continuation);
+            void Wait();
+
+        private:
+            // shared with the scheduler entries, which may run after the group executed their task itself and was destroyed
+            struct State
+            {
+                explicit State(TaskScheduler& scheduler) : scheduler(scheduler), pending(0) {}
+
+                TaskScheduler& scheduler;
+
+                std::mutex lock;
+                std::condition_variable condition;
+                uint32 pending;
+                std::deque<Task> tasks;                     // not started yet, taken by a worker or the waiting thread
+                std::vector<Task> continuations;
+            };
+
+            static void Dispatch(std::shared_ptr<State> const& state, Task task);
+            static void RunTask(std::shared_ptr<State> const& state, Task& task);
+
+            std::shared_ptr<State> m_state;
+    };
+}
+
+#define sTaskScheduler MaNGOS::Singleton<MaNGOS::TaskScheduler>::Instance()
+
+#endif
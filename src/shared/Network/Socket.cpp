@@ -29,12 +29,18 @@
 #include <vector>
 #include <functional>
 #include <cstring>
+#include <algorithm>
 
 namespace MaNGOS
 {
+    uint32 Socket::s_flushDelay = 2;
+    uint32 Socket::s_flushBytes = 4096;
+    uint32 Socket::s_flushPackets = 16;
+
     Socket::Socket(boost::asio::io_context& context, std::function<void (Socket*)> closeHandler)
         : m_writeState(WriteState::Idle), m_readState(ReadState::Idle), m_socket(context),
-          m_closeHandler(std::move(closeHandler)), m_outBufferFlushTimer(context), m_address("0.0.0.0"),
+          m_closeHandler(std::move(closeHandler)), m_outQueueInFlight(0), m_outQueueOffset(0),
+          m_bufferedBytes(0), m_bufferedPackets(0), m_outBufferFlushTimer(context), m_address("0.0.0.0"),
           m_remoteAddress(boost::asio::ip::address()), m_remotePort(0){}
 
     bool Socket::Open()
@@ -52,8 +58,6 @@ namespace MaNGOS
             return false;
         }
 
-        m_outBuffer.reset(new PacketBuffer);
-        m_secondaryOutBuffer.reset(new PacketBuffer);
         m_inBuffer.reset(new PacketBuffer);
 
         StartAsyncRead();
@@ -172,39 +176,68 @@ namespace MaNGOS
     {
         std::lock_guard<std::mutex> guard(m_mutex);
 
-        // get the correct buffer depending on the current writing state
-        PacketBuffer* outBuffer = m_writeState == WriteState::Sending ? m_secondaryOutBuffer.get() : m_outBuffer.get();
+        AppendOut(header, headerSize);
+        AppendOut(content, contentSize);
 
-        // write the header
-        outBuffer->Write(header, headerSize);
+        StartWriteFlushTimer(headerSize + contentSize);
+    }
 
-        // write the content
-        outBuffer->Write(content, contentSize);
+    void Socket::Write(const char* header, int headerSize, std::shared_ptr<const uint8> const& content, int contentSize)
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
 
-        // flush data if need
-        if (m_writeState == WriteState::Idle)
-            StartWriteFlushTimer();
+        if (contentSize < MinSharedWriteSize)
+        {
+            AppendOut(header, headerSize);
+            AppendOut(reinterpret_cast<const char*>(content.get()), contentSize);
+        }
+        else
+        {
+            // a segment opened for the header alone only has to hold the header
+            AppendOut(header, headerSize, headerSize);
+
+            OutSegment segment;
+            segment.shared = content;
+            segment.sharedSize = contentSize;
+            m_outQueue.push_back(std::move(segment));
+        }
+
+        StartWriteFlushTimer(headerSize + contentSize);
     }
 
     void Socket::Write(const char* buffer, int length)
     {
         std::lock_guard<std::mutex> guard(m_mutex);
 
-        // get the correct buffer depending on the current writing state
-        PacketBuffer* outBuffer = m_writeState == WriteState::Sending ? m_secondaryOutBuffer.get() : m_outBuffer.get();
+        AppendOut(buffer, length);
 
-        // write the header
-        outBuffer->Write(buffer, length);
+        StartWriteFlushTimer(length);
+    }
 
-        // flush data if need
-        if (m_writeState == WriteState::Idle)
-            StartWriteFlushTimer();
+// note that this function assumes that the socket mutex is locked
+    void Socket::AppendOut(const char* buffer, int length, size_t reserve)
+    {
+        if (length <= 0)
+            return;
+
+        // segments being sent must not move, start a new one
+        if (m_outQueue.size() <= m_outQueueInFlight || m_outQueue.back().shared || m_outQueue.back().owned.size() >= MaxCoalescedSize)
+        {
+            m_outQueue.emplace_back();
+            m_outQueue.back().owned.reserve(std::max(reserve, size_t(length)));
+        }
+
+        std::vector<uint8>& owned = m_outQueue.back().owned;
+        owned.insert(owned.end(), reinterpret_cast<const uint8*>(buffer), reinterpret_cast<const uint8*>(buffer) + length);
     }
 
 // note that this function assumes that the socket mutex is locked
-    void Socket::StartWriteFlushTimer()
+    void Socket::StartWriteFlushTimer(size_t length)
     {
-        if (m_writeState == WriteState::Buffering)
+        ++m_outputStats.packets;
+
+        // data written during a send goes out when it completes, batched with everything written meanwhile
+        if (m_writeState == WriteState::Sending)
             return;
 
         // if the socket is closed, silently fail
@@ -214,10 +247,38 @@ namespace MaNGOS
             return;
         }
 
-        m_writeState = WriteState::Buffering;
+        if (m_writeState == WriteState::Idle)
+        {
+            m_writeState = WriteState::Buffering;
+            m_bufferingStart = std::chrono::steady_clock::now();
+            m_bufferedBytes = 0;
+            m_bufferedPackets = 0;
+        }
+        else if (!s_flushDelay)
+            return;                                         // flush already posted
+
+        m_bufferedBytes += length;
+        ++m_bufferedPackets;
+
+        bool const full = (s_flushBytes && m_bufferedBytes >= s_flushBytes) || (s_flushPackets && m_bufferedPackets >= s_flushPackets);
+
+        // timer already running, a cancelled wait flushes too
+        if (m_bufferedPackets > 1)
+        {
+            if (full)
+                m_outBufferFlushTimer.cancel();
+            return;
+        }
 
         std::shared_ptr<Socket> ptr = shared<Socket>();
-        m_outBufferFlushTimer.expires_from_now(boost::posix_time::milliseconds(int(BufferTimeout)));
+
+        if (full || !s_flushDelay)
+        {
+            boost::asio::post(m_socket.get_executor(), [ptr]() { ptr->FlushOut(); });
+            return;
+        }
+
+        m_outBufferFlushTimer.expires_from_now(boost::posix_time::milliseconds(int(s_flushDelay)));
         m_outBufferFlushTimer.async_wait([ptr](const boost::system::error_code&) { ptr->FlushOut(); });
     }
 
@@ -234,18 +295,55 @@ namespace MaNGOS
 
         assert(m_writeState == WriteState::Buffering);
 
-        // at this point we are guarunteed that there is data to send in the primary buffer.  send it.
+        uint64 const delay = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_bufferingStart).count();
+        ++m_outputStats.flushes;
+        m_outputStats.totalDelay += delay;
+        if (delay > m_outputStats.maxDelay)
+            m_outputStats.maxDelay = delay;
+
+        // at this point we are guarunteed that there is data to send in the queue.  send it.
         m_writeState = WriteState::Sending;
 
+        StartSend();
+    }
+
+// note that this function assumes that the socket mutex is locked
+    void Socket::StartSend()
+    {
+        // gather the queued segments in one send call
+        std::vector<boost::asio::const_buffer> buffers;
+        buffers.reserve(m_outQueue.size() < MaxSendSegments ? m_outQueue.size() : MaxSendSegments);
+
+        for (std::deque<OutSegment>::const_iterator itr = m_outQueue.begin(); itr != m_outQueue.end() && buffers.size() < MaxSendSegments; ++itr)
+        {
+            size_t const offset = buffers.empty() ? m_outQueueOffset : 0;
+            buffers.push_back(boost::asio::const_buffer(itr->Data() + offset, itr->Size() - offset));
+        }
+
+        m_outQueueInFlight = buffers.size();
+
         std::shared_ptr<Socket> ptr = shared<Socket>();
-        m_socket.async_write_some(boost::asio::buffer(m_outBuffer->m_buffer, m_outBuffer->m_writePosition),
-                                  make_custom_alloc_handler(m_allocator,
+        m_socket.async_write_some(buffers, make_custom_alloc_handler(m_allocator,
         [ptr](const boost::system::error_code & error, size_t length) { ptr->OnWriteComplete(error, length); }));
     }
 
+    SocketOutputStats Socket::GetOutputStats()
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        return m_outputStats;
+    }
+
+    void Socket::SetFlushPolicy(uint32 delay, uint32 bytes, uint32 packets)
+    {
+        s_flushDelay = delay;
+        s_flushBytes = bytes;
+        s_flushPackets = packets;
+    }
+
 // if the write state is idle, this will do nothing, which is correct
 // if the write state is sending, this will do nothing, which is correct
 // if the write state is buffering, this will cancel the running timer, which will immediately trigger FlushOut()
+// (when the flush was posted instead, it is already on its way)
     void Socket::ForceFlushOut()
     {
         m_outBufferFlushTimer.cancel();
@@ -270,37 +368,32 @@ namespace MaNGOS
         std::lock_guard<std::mutex> guard(m_mutex);
 
         assert(m_writeState == WriteState::Sending);
-        assert(length <= m_outBuffer->m_writePosition);
 
-        // if there is data left to write, move it to the start of the buffer
-        if (length < m_outBuffer->m_writePosition)
-        {
-            memcpy(&(m_outBuffer->m_buffer[0]), &(m_outBuffer->m_buffer[length]), (m_outBuffer->m_writePosition - length) * sizeof(m_outBuffer->m_buffer[0]));
-            m_outBuffer->m_writePosition -= length;
-        }
-        // if not, reset the write pointer
-        else
-            m_outBuffer->m_writePosition = 0;
+        ++m_outputStats.sendCalls;
+        m_outputStats.bytes += length;
 
-        // if there is data in the secondary buffer, append it to the primary buffer
-        if (m_secondaryOutBuffer->m_writePosition > 0)
+        // drop what was sent, a segment can be sent partially
+        while (length > 0)
         {
-            // do we have enough space? if not, resize
-            if (m_outBuffer->m_buffer.size() < (m_outBuffer->m_writePosition + m_secondaryOutBuffer->m_writePosition))
-                m_outBuffer->m_buffer.resize(m_outBuffer->m_writePosition + m_secondaryOutBuffer->m_writePosition);
+            assert(!m_outQueue.empty());
 
-            memcpy(&(m_outBuffer->m_buffer[m_outBuffer->m_writePosition]), &(m_secondaryOutBuffer->m_buffer[0]), (m_secondaryOutBuffer->m_writePosition) * sizeof(m_secondaryOutBuffer->m_buffer[0]));
+            size_t const left = m_outQueue.front().Size() - m_outQueueOffset;
+            if (length < left)
+            {
+                m_outQueueOffset += length;
+                break;
+            }
 
-            m_outBuffer->m_writePosition += m_secondaryOutBuffer->m_writePosition;
-            m_secondaryOutBuffer->m_writePosition = 0;
+            length -= left;
+            m_outQueueOffset = 0;
+            m_outQueue.pop_front();
         }
 
-        std::shared_ptr<Socket> ptr = shared<Socket>();
+        m_outQueueInFlight = 0;
+
         // if there is any data to write, do so immediately
-        if (m_outBuffer->m_writePosition > 0)
-            m_socket.async_write_some(boost::asio::buffer(m_outBuffer->m_buffer, m_outBuffer->m_writePosition),
-                                      make_custom_alloc_handler(m_allocator,
-            [ptr](const boost::system::error_code & error, size_t length) { ptr->OnWriteComplete(error, length);}));
+        if (!m_outQueue.empty())
+            StartSend();
         else
             m_writeState = WriteState::Idle;
     }
@@ -29,20 +29,36 @@
 #include <string>
 #include <mutex>
 #include <functional>
+#include <deque>
+#include <vector>
+#include <chrono>
 
 namespace MaNGOS
 {
+    struct SocketOutputStats
+    {
+        SocketOutputStats() : packets(0), bytes(0), flushes(0), sendCalls(0), totalDelay(0), maxDelay(0) {}
+
+        uint64 packets;                                     // writes queued
+        uint64 bytes;                                       // bytes sent
+        uint64 flushes;                                     // times buffered data started to be sent
+        uint64 sendCalls;                                   // completed send system calls
+        uint64 totalDelay;                                  // microseconds between the first buffered write and its flush
+        uint64 maxDelay;
+    };
+
     class Socket : public std::enable_shared_from_this<Socket>
     {
         private:
-            // buffer timeout period, in milliseconds.  higher values decrease responsiveness
-            // ingame but increase bandwidth efficiency by reducing tcp overhead.
-            static const int BufferTimeout = 50;
+            // output flush policy, see SetFlushPolicy()
+            static uint32 s_flushDelay;
+            static uint32 s_flushBytes;
+            static uint32 s_flushPackets;
 
             enum class WriteState
             {
                 Idle,       // no write operation is currently underway
-                Buffering,  // a write operation has been performed, and we are currently awaiting others before sending
+                Buffering,  // a write operation has been performed, and we are currently awaiting others or a threshold before sending
                 Sending,    // a send operation is underway
             };
 
@@ -59,9 +75,34 @@ namespace MaNGOS
 
             std::function<void(Socket *)> m_closeHandler;
 
+            // outgoing data, either copied in the socket or a payload shared with other sockets
+            struct OutSegment
+            {
+                OutSegment() : sharedSize(0) {}
+
+                std::vector<uint8> owned;
+                std::shared_ptr<const uint8> shared;
+                size_t sharedSize;
+
+                const uint8* Data() const { return shared ? shared.get() : owned.data(); }
+                size_t Size() const { return shared ? sharedSize : owned.size(); }
+            };
+
+            // small writes are appended to the last owned segment up to this size
+            static const size_t MaxCoalescedSize = 16 * 1024;
+            // segments given to one send call (writev)
+            static const size_t MaxSendSegments = 64;
+
             std::unique_ptr<PacketBuffer> m_inBuffer;
-            std::unique_ptr<PacketBuffer> m_outBuffer;
-            std::unique_ptr<PacketBuffer> m_secondaryOutBuffer;
+
+            std::deque<OutSegment> m_outQueue;
+            size_t m_outQueueInFlight;                      // front segments used by the running send, never appended to
+            size_t m_outQueueOffset;                        // bytes of the front segment already sent
+
+            uint32 m_bufferedBytes;                         // written since the buffering started
+            uint32 m_bufferedPackets;
+            std::chrono::steady_clock::time_point m_bufferingStart;
+            SocketOutputStats m_outputStats;
 
             std::mutex m_mutex;
             std::mutex m_closeMutex;
@@ -70,10 +111,13 @@ namespace MaNGOS
             void StartAsyncRead();
             void OnRead(const boost::system::error_code &error, size_t length);
 
-            void StartWriteFlushTimer();
+            void StartWriteFlushTimer(size_t length);
             void OnWriteComplete(const boost::system::error_code &error, size_t length);
             void FlushOut();
 
+            void AppendOut(const char* buffer, int length, size_t reserve = DEFAULT_BUFFER_SIZE);
+            void StartSend();
+
             void OnError(const boost::system::error_code &error);
 
         protected:
@@ -105,6 +149,11 @@ namespace MaNGOS
 
             void Write(const char *buffer, int length);
             void Write(const char *header, int headerSize, const char* content, int contentSize);
+            // content is not copied, it is kept alive until sent (unless smaller than MinSharedWriteSize)
+            void Write(const char *header, int headerSize, std::shared_ptr<const uint8> const& content, int contentSize);
+
+            // shared content below this size is copied, a segment of its own costs more than the copy
+            static const int MinSharedWriteSize = 512;
 
             boost::asio::ip::tcp::socket &GetAsioSocket() { return m_socket; }
 
@@ -117,6 +166,12 @@ namespace MaNGOS
             boost::asio::ip::address GetRemoteIpAddress() const { return m_remoteAddress; }
             uint16 GetRemotePort() const { return m_remotePort; }
 
+            SocketOutputStats GetOutputStats();
+
+            // buffered data of an idle socket is sent after delay milliseconds (0: as soon as the network thread is free)
+            // or as soon as bytes or packets are buffered (0: no limit), data written during a send goes with the next one
+            static void SetFlushPolicy(uint32 delay, uint32 bytes, uint32 packets);
+
         private:
             // custom allocator based on example from http://www.boost.org/doc/libs/1_62_0/doc/html/boost_asio/example/cpp11/allocation/server.cpp
 
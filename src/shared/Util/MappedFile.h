@@ -0,0 +1,62 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOSSERVER_MAPPEDFILE_H
+#define MANGOSSERVER_MAPPEDFILE_H
+
+#include "Platform/Define.h"
+
+/**
+ * Read only view of a whole file mapped in memory.
+ *
+ * Pages are loaded on first access and shared through the system file cache
+ * with every other mapping of the same file, also from other processes.
+ * A copy on write mapping may be written to, the written pages become private
+ * copies and the file itself is never modified.
+ */
+class MappedFile
+{
+    public:
+        MappedFile() : m_data(nullptr), m_size(0) {}
+        ~MappedFile() { Close(); }
+
+        MappedFile(MappedFile const&) = delete;
+        MappedFile& operator=(MappedFile const&) = delete;
+
+        bool Open(char const* fileName, bool copyOnWrite = false);
+        void Close();
+
+        bool IsOpen() const { return m_data != nullptr; }
+        uint8* GetData() const { return m_data; }
+        size_t GetSize() const { return m_size; }
+
+        /// Pointer to count objects of T at offset, nullptr if they are out of the file or misaligned
+        template<typename T>
+        T* GetAt(size_t offset, size_t count = 1) const
+        {
+            if (offset > m_size || count > (m_size - offset) / sizeof(T) || (offset % alignof(T)) != 0)
+                return nullptr;
+            return reinterpret_cast<T*>(m_data + offset);
+        }
+
+    private:
+        uint8* m_data;
+        size_t m_size;
+};
+
+#endif